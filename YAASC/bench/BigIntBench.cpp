@@ -0,0 +1,119 @@
+// Finds the limb counts where Karatsuba, Toom-3 and recursive division start to pay off.
+// Build: g++ -O2 -std=c++17 bench/BigIntBench.cpp src/BigInt.cpp -o bigint_bench
+
+#include <chrono>
+#include <random>
+#include <climits>
+#include <iostream>
+#include <functional>
+
+#include "../src/BigInt.h"
+
+static std::mt19937 generator(42);
+
+static BigInt RandomBigInt(int limbs)
+{
+	BigInt::Limbs magnitude(limbs);
+
+	for (std::uint32_t& limb : magnitude)
+		limb = generator();
+
+	magnitude.back() |= 0x80000000u;
+
+	return BigInt(magnitude, false);
+}
+
+// Microseconds per call, best of a few rounds
+static double Time(const std::function<void()>& operation)
+{
+	double best = 1e30;
+
+	for (int round = 0; round < 5; round++)
+	{
+		int calls = 0;
+		auto start = std::chrono::steady_clock::now();
+		std::chrono::duration<double, std::micro> elapsed{ 0 };
+
+		while (elapsed.count() < 20000.0)
+		{
+			operation();
+			calls++;
+			elapsed = std::chrono::steady_clock::now() - start;
+		}
+
+		best = std::min(best, elapsed.count() / calls);
+	}
+
+	return best;
+}
+
+// Smallest size where using the algorithm for one level beats not using it at all, three sizes in a row
+static int Crossover(const char* name, int& threshold, const std::function<std::function<void()>(int)>& prepare)
+{
+	int found = INT_MAX;
+	int wins = 0;
+	int first_win = INT_MAX;
+
+	std::cout << name << " (without / with)\n";
+
+	for (int limbs = 8; limbs <= 4096; limbs += limbs / 4)
+	{
+		std::function<void()> operation = prepare(limbs);
+
+		threshold = INT_MAX;
+		double without = Time(operation);
+		threshold = limbs;
+		double with = Time(operation);
+
+		std::cout << "\t" << limbs << " limbs: " << without << " us / " << with << " us\n";
+
+		if (with < without)
+		{
+			if (wins++ == 0)
+				first_win = limbs;
+
+			if (wins == 3 && found == INT_MAX)
+				found = first_win;
+		}
+		else
+			wins = 0;
+	}
+
+	return found;
+}
+
+int main()
+{
+	BigInt a;
+	BigInt b;
+	BigInt result;
+
+	auto multiply = [&](int limbs) -> std::function<void()>
+	{
+		a = RandomBigInt(limbs);
+		b = RandomBigInt(limbs);
+		return [&]() { result = a * b; };
+	};
+
+	auto divide = [&](int limbs) -> std::function<void()>
+	{
+		a = RandomBigInt(2 * limbs);
+		b = RandomBigInt(limbs);
+		return [&]() { result = a / b; };
+	};
+
+	BigInt::toom3_threshold = INT_MAX;
+	int karatsuba = Crossover("Karatsuba", BigInt::karatsuba_threshold, multiply);
+	BigInt::karatsuba_threshold = karatsuba;
+
+	int toom3 = Crossover("Toom-3", BigInt::toom3_threshold, multiply);
+	BigInt::toom3_threshold = toom3;
+
+	int division = Crossover("Burnikel-Ziegler", BigInt::division_threshold, divide);
+
+	std::cout << "\nkaratsuba_threshold = " << karatsuba
+	          << "\ntoom3_threshold = " << toom3
+	          << "\ndivision_threshold = " << division << '\n';
+
+	return 0;
+}
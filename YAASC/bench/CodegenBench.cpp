@@ -0,0 +1,99 @@
+// Compares the bytecode machine with native code generated for the same expression and
+// loaded with dlopen, evaluating one point at a time.
+// Build: g++ -O2 -std=c++17 bench/CodegenBench.cpp $(ls src/*.cpp | grep -v main.cpp) -o codegen_bench -pthread -ldl
+
+#include <chrono>
+#include <random>
+#include <iostream>
+#include <functional>
+
+#include "../src/Codegen.h"
+#include "../src/Bytecode.h"
+#include "../src/Parser.h"
+
+constexpr std::size_t points = 1 << 20;
+
+// Nanoseconds per point, best of a few rounds
+static double Time(const std::function<double()>& operation)
+{
+	double best = 1e30;
+	volatile double sink = 0.0;
+
+	for (int round = 0; round < 5; round++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		sink = sink + operation();
+		std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+		best = std::min(best, elapsed.count() / points);
+	}
+
+	return best;
+}
+
+int main()
+{
+	std::vector<std::string> inputs{
+		"3x^5-2x^3y+xy^-2+7",
+		"sin(x^2)+x^4cos(x^2)+(x^2+y)^3",
+		"ln(x^2+1)+log2(y^2+1)",
+		"x^y+2^x",
+		"(x+y)^7-(x-y)^7+(x+y)^5(x-y)^2"
+	};
+
+	std::mt19937 generator(42);
+	std::uniform_real_distribution<double> distribution(0.5, 2.0);
+	std::vector<double> x(points), y(points);
+
+	for (std::size_t i = 0; i < points; i++)
+	{
+		x[i] = distribution(generator);
+		y[i] = distribution(generator);
+	}
+
+	for (const std::string& input : inputs)
+	{
+		std::unique_ptr<Expr> expr = parser::Parse(input);
+		bytecode::Program program(expr);
+		bytecode::Machine machine(program);
+		codegen::Library library;
+
+		if (!library.Compile(expr))
+		{
+			std::cout << input << ": couldn't compile\n";
+			continue;
+		}
+
+		auto run = [&](const std::vector<symbol::Id>& variables, const std::function<double(const double*)>& evaluate)
+		{
+			std::vector<double> slots(variables.size());
+			bool x_first = !variables.empty() && symbol::Name(variables[0]) == "x";
+
+			return Time([&]()
+				{
+					double sum = 0.0;
+
+					for (std::size_t i = 0; i < points; i++)
+					{
+						if (slots.size() > 0)
+							slots[0] = x_first ? x[i] : y[i];
+
+						if (slots.size() > 1)
+							slots[1] = x_first ? y[i] : x[i];
+
+						sum += evaluate(slots.data());
+					}
+
+					return sum;
+				});
+		};
+
+		codegen::Function function = library.Get();
+		double interpreted = run(program.Variables(), [&](const double* slots) { return machine.Run(slots); });
+		double native = run(library.Variables(), [&](const double* slots) { return function(slots); });
+
+		std::cout << input << ": " << interpreted << " ns / " << native << " ns per point, "
+		          << interpreted / native << "x\n";
+	}
+
+	return 0;
+}
@@ -0,0 +1,90 @@
+// Finds the lengths where Karatsuba and the number-theoretic transform start to pay off for
+// dense polynomial products, and compares a univariate power with the sparse heap product.
+// Build: g++ -O2 -std=c++17 bench/DenseBench.cpp $(ls src/*.cpp | grep -v main.cpp) -o dense_bench -pthread -ldl
+
+#include <chrono>
+#include <random>
+#include <iostream>
+#include <functional>
+
+#include "../src/Dense.h"
+#include "../src/Polynomial.h"
+
+static std::mt19937 generator(42);
+
+static poly::Dense Random(std::size_t length, int limbs)
+{
+	poly::Dense coefficients(length);
+
+	for (BigInt& coefficient : coefficients)
+	{
+		BigInt::Limbs magnitude(limbs);
+
+		for (std::uint32_t& limb : magnitude)
+			limb = generator();
+
+		coefficient = BigInt(magnitude, generator() % 2 == 0);
+	}
+
+	return coefficients;
+}
+
+// Microseconds per call, best of a few rounds
+static double Time(const std::function<void()>& operation)
+{
+	double best = 1e30;
+
+	for (int round = 0; round < 5; round++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		operation();
+		std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+		best = std::min(best, elapsed.count());
+	}
+
+	return best;
+}
+
+int main()
+{
+	for (int limbs : { 1, 2 })
+	{
+		std::cout << limbs << " limb coefficients\n";
+
+		for (std::size_t length : { 16, 24, 32, 48, 64, 96, 128, 256, 1024, 4096 })
+		{
+			poly::Dense a = Random(length, limbs);
+			poly::Dense b = Random(length, limbs);
+			poly::Dense product;
+
+			double schoolbook = length <= 1024 ? Time([&]() { poly::MulSchoolbook(a, b); }) : 0.0;
+			double karatsuba = Time([&]() { poly::MulKaratsuba(a, b); });
+			double ntt = Time([&]() { poly::MulNtt(a, b, product); });
+
+			std::cout << "  " << length << ": schoolbook " << schoolbook << " us, karatsuba " << karatsuba
+			          << " us, ntt " << ntt << " us\n";
+		}
+	}
+
+	symbol::Id x = symbol::Intern("x");
+	poly::Polynomial base = poly::Polynomial::Variable(x) + poly::Polynomial(3);
+
+	for (unsigned n : { 100, 400, 1600 })
+	{
+		poly::Polynomial power;
+		poly::Polynomial sparse;
+
+		double dense_time = Time([&]() { power = base.Pow(n); });
+		double sparse_time = Time([&]() {
+			sparse = base;
+
+			for (unsigned i = 1; i < n; i++)
+				sparse = poly::HeapProduct(sparse, base);
+		});
+
+		std::cout << "(x+3)^" << n << ": dense " << dense_time << " us, heap " << sparse_time << " us"
+		          << (power == sparse ? "" : ", DIFFERENT RESULT") << "\n";
+	}
+
+	return 0;
+}
@@ -0,0 +1,82 @@
+// Compares evaluating an expression one point at a time with the bytecode machine against
+// evaluating whole columns with the vector kernels.
+// Build: g++ -O2 -std=c++17 -mavx2 bench/EvalBench.cpp $(ls src/*.cpp | grep -v main.cpp) -o eval_bench -pthread -ldl
+
+#include <chrono>
+#include <random>
+#include <iostream>
+#include <functional>
+
+#include "../src/Simd.h"
+#include "../src/Parser.h"
+
+constexpr std::size_t points = 1 << 20;
+
+// Nanoseconds per point, best of a few rounds
+static double Time(const std::function<void()>& operation)
+{
+	double best = 1e30;
+
+	for (int round = 0; round < 5; round++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		operation();
+		std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+		best = std::min(best, elapsed.count() / points);
+	}
+
+	return best;
+}
+
+int main()
+{
+	std::vector<std::string> inputs{
+		"3x^5-2x^3y+xy^-2+7",
+		"sin(x)cos(y)+tan(x/4)",
+		"ln(x^2+1)+log2(y^2+1)",
+		"x^y+2^x",
+		"e^(-x^2/2)y"
+	};
+
+	std::mt19937 generator(42);
+	std::uniform_real_distribution<double> distribution(0.5, 2.0);
+	std::vector<double> x(points), y(points), out(points);
+
+	for (std::size_t i = 0; i < points; i++)
+	{
+		x[i] = distribution(generator);
+		y[i] = distribution(generator);
+	}
+
+	std::cout << "vector width: " << simd::Width() << " lanes, " << points << " points\n";
+
+	for (const std::string& input : inputs)
+	{
+		bytecode::Program program(parser::Parse(input));
+		std::vector<const double*> columns;
+
+		for (symbol::Id id : program.Variables())
+			columns.push_back(symbol::Name(id) == "x" ? x.data() : y.data());
+
+		bytecode::Machine machine(program);
+		std::vector<double> slots(columns.size());
+
+		double scalar = Time([&]()
+			{
+				for (std::size_t i = 0; i < points; i++)
+				{
+					for (std::size_t k = 0; k < columns.size(); k++)
+						slots[k] = columns[k][i];
+
+					out[i] = machine.Run(slots);
+				}
+			});
+
+		double vector = Time([&]() { simd::Evaluate(program, columns, points, out.data()); });
+
+		std::cout << input << ": " << scalar << " ns / " << vector << " ns per point, "
+		          << scalar / vector << "x\n";
+	}
+
+	return 0;
+}
@@ -0,0 +1,85 @@
+// Expands large powers and products with 1, 2, 4, ... threads up to the number of cores,
+// and checks that every thread count gives the same result.
+// Build: g++ -O2 -std=c++17 bench/ExpandBench.cpp $(ls src/*.cpp | grep -v main.cpp) -o expand_bench -pthread -ldl
+
+#include <chrono>
+#include <iostream>
+#include <functional>
+
+#include "../src/Polynomial.h"
+#include "../src/PowerOfSum.h"
+#include "../src/Parallel.h"
+#include "../src/Parser.h"
+
+// Milliseconds, best of a few rounds
+static double Time(const std::function<void()>& operation)
+{
+	double best = 1e30;
+
+	for (int round = 0; round < 3; round++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		operation();
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+		best = std::min(best, elapsed.count());
+	}
+
+	return best;
+}
+
+static poly::Polynomial FromString(const std::string& input)
+{
+	poly::Polynomial polynomial;
+	poly::FromExpr(parser::Parse(input), polynomial);
+
+	return polynomial;
+}
+
+int main()
+{
+	poly::Polynomial p = FromString("(x+y+z+w+1)^12");
+	poly::Polynomial q = FromString("(x-y+2z-w+3)^12");
+
+	std::vector<int> thread_counts;
+
+	for (int threads = 1; threads < parallel::DefaultThreads(); threads *= 2)
+		thread_counts.push_back(threads);
+
+	thread_counts.push_back(parallel::DefaultThreads());
+
+	poly::Polynomial first_power;
+	poly::Polynomial first_product;
+	std::size_t first_hash = 0;
+
+	for (int threads : thread_counts)
+	{
+		parallel::SetThreads(threads);
+
+		poly::Polynomial power;
+		poly::Polynomial product;
+		std::unique_ptr<Expr> tree;
+
+		double power_time = Time([&]() { power = FromString("(x+y+z+w)^40"); });
+		double product_time = Time([&]() { product = p * q; });
+		double tree_time = Time([&]() {
+			tree = parser::Parse("(x+y+sin(z)+w+1)^24");
+			algebra::ApplyMultinomialTheorem(tree);
+		});
+
+		if (threads == 1)
+		{
+			first_power = power;
+			first_product = product;
+			first_hash = tree->Hash();
+		}
+
+		bool same = power == first_power && product == first_product && tree->Hash() == first_hash;
+
+		std::cout << threads << " threads: (x+y+z+w)^40 " << power_time << " ms, "
+		          << p.Terms() << " x " << q.Terms() << " terms " << product_time << " ms, "
+		          << "multinomial tree " << tree_time << " ms"
+		          << (same ? "" : ", DIFFERENT RESULT") << "\n";
+	}
+
+	return 0;
+}
@@ -5,7 +5,7 @@ namespace algebra {
 // abc+3bca+4cab+...
 void AddVariables(std::unique_ptr<Expr>& expr)
 {
-	if (expr->IsTerminal())
+	if (expr->IsTerminal() || expr->Settled())
 		return;
 
 	if (expr->IsGeneric())
@@ -22,9 +22,19 @@ void AddVariables(std::unique_ptr<Expr>& expr)
 			AddVariables(expr->Right());
 	}
 
+	expr->Rehash();
+	AddVariablesNode(expr);
+}
+
+void AddVariablesNode(std::unique_ptr<Expr>& expr)
+{
 	if (!expr->IsAdd())
 		return;
 
+	// Sums of monomials are collected in one pass over their polynomial
+	if (poly::CollectTerms(expr))
+		return;
+
 	if (expr->IsGeneric())
 		AddGenNode(expr);
 	else
@@ -107,11 +117,7 @@ void AddGenNode(std::unique_ptr<Expr>& expr)
 		{
 			for (int j = i + 1; j < children_size; j++)
 			{
-				std::unique_ptr<Expr> old;
-				tree_util::Clone(old, expr->ChildAt(i));
-				AddGenNodes(expr, i, expr->ChildAt(i), expr->ChildAt(j));
-
-				if (old != expr->ChildAt(i))
+				if (AddGenNodes(expr, i, expr->ChildAt(i), expr->ChildAt(j)))
 					expr->SetChildAt(j, std::make_unique<Integer>(0));
 			}
 		}
@@ -130,19 +136,25 @@ void AddGenNode(std::unique_ptr<Expr>& expr)
 *  a  b  a --> *   b
 *             / \
 *            2   a
+*
+*  Returns true when child_b was merged into the child at index.
 */
-void AddGenNodes(std::unique_ptr<Expr>& root, int index, std::unique_ptr<Expr>& child_a, std::unique_ptr<Expr>& child_b)
+bool AddGenNodes(std::unique_ptr<Expr>& root, int index, std::unique_ptr<Expr>& child_a, std::unique_ptr<Expr>& child_b)
 {
 	std::unique_ptr<Expr> multiplier = std::make_unique<Integer>(1);
 
 	if (child_a == child_b)
+	{
 		root->SetChildAt(index, std::make_unique<Mul>(std::make_unique<Integer>(2), std::move(child_a)));
+		return true;
+	}
 	else if (IsMultipliedByNumber(child_a) && IsMultipliedByNumber(child_b))
 	{
 		if (child_a->Right() == child_b->Right())
 		{
 			multiplier = std::move(calc::AddNumbers(child_a->Left(), child_b->Left()));
 			root->SetChildAt(index, std::make_unique<Mul>(std::move(multiplier), std::move(child_a->Right())));
+			return true;
 		}
 	}
 	else if (IsMultipliedByNumber(child_a))
@@ -151,6 +163,7 @@ void AddGenNodes(std::unique_ptr<Expr>& root, int index, std::unique_ptr<Expr>&
 		{
 			multiplier = std::move(calc::AddNumbers(multiplier, child_a->Left()));
 			root->SetChildAt(index, std::make_unique<Mul>(std::move(multiplier), std::move(child_b)));
+			return true;
 		}
 	}
 	else if (IsMultipliedByNumber(child_b))
@@ -159,6 +172,7 @@ void AddGenNodes(std::unique_ptr<Expr>& root, int index, std::unique_ptr<Expr>&
 		{
 			multiplier = std::move(calc::AddNumbers(multiplier, child_b->Left()));
 			root->SetChildAt(index, std::make_unique<Mul>(std::move(multiplier), std::move(child_a)));
+			return true;
 		}
 	}
 	else if (CanAddGenNode(child_a, child_b))
@@ -166,19 +180,24 @@ void AddGenNodes(std::unique_ptr<Expr>& root, int index, std::unique_ptr<Expr>&
 		multiplier = std::move(calc::AddNumbers(child_a->ChildAt(0), child_b->ChildAt(0)));
 		child_a->SetChildAt(0, std::move(multiplier));
 		root->SetChildAt(index, std::move(child_a));
+		return true;
 	}
 	else if (SameGenVariables(child_a, child_b))
 	{
 		multiplier = std::move(calc::AddNumbers(multiplier, child_a->ChildAt(0)));
 		child_a->SetChildAt(0, std::move(multiplier));
 		root->SetChildAt(index, std::move(child_a));
+		return true;
 	}
 	else if (SameGenVariables(child_b, child_a))
 	{
 		multiplier = std::move(calc::AddNumbers(multiplier, child_b->ChildAt(0)));
 		child_b->SetChildAt(0, std::move(multiplier));
 		root->SetChildAt(index, std::move(child_b));
+		return true;
 	}
+
+	return false;
 }
 
 bool IsMultipliedByNumber(const std::unique_ptr<Expr>& expr)
@@ -5,13 +5,15 @@
 #include "Expr.h"
 #include "TreeUtil.h"
 #include "Calculator.h"
+#include "Polynomial.h"
 
 namespace algebra {
 
 void AddVariables(std::unique_ptr<Expr>& expr);
+void AddVariablesNode(std::unique_ptr<Expr>& expr);
 void AddBinNodes(std::unique_ptr<Expr>& root, std::unique_ptr<Expr>& left, std::unique_ptr<Expr>& right);
 void AddGenNode(std::unique_ptr<Expr>& expr);
-void AddGenNodes(std::unique_ptr<Expr>& root, int index, std::unique_ptr<Expr>& child_a, std::unique_ptr<Expr>& child_b);
+bool AddGenNodes(std::unique_ptr<Expr>& root, int index, std::unique_ptr<Expr>& child_a, std::unique_ptr<Expr>& child_b);
 
 bool IsMultipliedByNumber(const std::unique_ptr<Expr>& expr);
 bool IsGenMultipliedByNumber(const std::unique_ptr<Expr>& expr);
@@ -0,0 +1,514 @@
+#include <fstream>
+#include <unordered_map>
+
+#if !defined _WIN32
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
+#include "Archive.h"
+
+namespace archive {
+
+static std::uint64_t Align(std::uint64_t offset)
+{
+	return (offset + alignment - 1) / alignment * alignment;
+}
+
+template<typename T>
+static void WriteSection(std::ostream& out, const std::vector<T>& section, std::uint64_t offset, std::uint64_t& position)
+{
+	static const char padding[alignment] = {};
+
+	out.write(padding, static_cast<std::streamsize>(offset - position));
+	out.write(reinterpret_cast<const char*>(section.data()), static_cast<std::streamsize>(section.size() * sizeof(T)));
+	position = offset + section.size() * sizeof(T);
+}
+
+// The number of children a node of this kind must have
+static bool ValidArity(ExprType type, bool generic, int child_count)
+{
+	switch (type)
+	{
+	case ExprType::INTEGER:
+	case ExprType::FLOAT:
+	case ExprType::FRACTION:
+	case ExprType::VARIABLE:
+	case ExprType::PI:
+	case ExprType::e:
+		return child_count == 0;
+	case ExprType::MUL:
+	case ExprType::ADD:
+		return generic ? child_count > 0 : child_count == 2;
+	case ExprType::POW:
+	case ExprType::LOG:
+	case ExprType::LN: // The base e is kept as a second child, like in flat::Tree
+		return child_count == 2;
+	case ExprType::FAC:
+	case ExprType::SIN:
+	case ExprType::COS:
+	case ExprType::TAN:
+	case ExprType::DERIVATIVE:
+	case ExprType::INTEGRAL:
+		return child_count == 1;
+	default:
+		break;
+	}
+
+	return false;
+}
+
+void Write(const flat::Tree& tree, std::ostream& out)
+{
+	std::vector<Node> nodes(tree.Size());
+	std::vector<std::uint64_t> symbol_offsets{ 0 };
+	std::vector<char> names;
+	std::vector<IntegerRecord> integers;
+	std::vector<std::uint32_t> limbs;
+	std::vector<float> floats;
+	std::vector<FractionRecord> fractions;
+
+	std::unordered_map<symbol::Id, int> file_symbols;
+
+	auto add_integer = [&](const BigInt& value)
+	{
+		IntegerRecord record{ value.Small(), limbs.size(), 0, value.Sign() < 0 };
+
+		if (!value.IsSmall())
+		{
+			BigInt::Limbs magnitude = value.Magnitude();
+			record.limb_count = (std::uint32_t)magnitude.size();
+			limbs.insert(limbs.end(), magnitude.begin(), magnitude.end());
+		}
+
+		integers.push_back(record);
+		return (std::int64_t)integers.size() - 1;
+	};
+
+	auto add_symbol = [&](symbol::Id id)
+	{
+		auto found = file_symbols.find(id);
+
+		if (found != file_symbols.end())
+			return found->second;
+
+		const std::string& name = symbol::Name(id);
+		names.insert(names.end(), name.begin(), name.end());
+		symbol_offsets.push_back(names.size());
+
+		return file_symbols[id] = (int)file_symbols.size();
+	};
+
+	for (flat::Index i = 0; i < tree.Size(); i++)
+	{
+		Node& node = nodes[i];
+		node.kind = (std::uint8_t)tree.Kind(i);
+		node.generic = tree.IsGeneric(i);
+		node.reserved = 0;
+		node.child_count = tree.ChildrenSize(i);
+		node.size = tree.SubtreeSize(i);
+
+		switch (tree.Kind(i))
+		{
+		case ExprType::INTEGER:
+			node.payload = (std::int32_t)add_integer(tree.bValue(i));
+			break;
+		case ExprType::FLOAT:
+			floats.push_back(tree.fValue(i));
+			node.payload = (std::int32_t)floats.size() - 1;
+			break;
+		case ExprType::FRACTION:
+		{
+			std::int64_t numerator = add_integer(tree.rValue(i).Numerator());
+			fractions.push_back({ numerator, add_integer(tree.rValue(i).Denominator()) });
+			node.payload = (std::int32_t)fractions.size() - 1;
+			break;
+		}
+		default:
+			node.payload = tree.Symbol(i) == symbol::none ? -1 : add_symbol(tree.Symbol(i));
+			break;
+		}
+	}
+
+	Header header{};
+	std::copy(magic, magic + 4, header.magic);
+	header.version = version;
+	header.byte_order = byte_order;
+
+	header.nodes = nodes.size();
+	header.node_offset = Align(sizeof(Header));
+	header.symbols = symbol_offsets.size() - 1;
+	header.symbol_offset = Align(header.node_offset + nodes.size() * sizeof(Node));
+	header.name_bytes = names.size();
+	header.name_offset = Align(header.symbol_offset + symbol_offsets.size() * sizeof(std::uint64_t));
+	header.integers = integers.size();
+	header.integer_offset = Align(header.name_offset + names.size());
+	header.limbs = limbs.size();
+	header.limb_offset = Align(header.integer_offset + integers.size() * sizeof(IntegerRecord));
+	header.floats = floats.size();
+	header.float_offset = Align(header.limb_offset + limbs.size() * sizeof(std::uint32_t));
+	header.fractions = fractions.size();
+	header.fraction_offset = Align(header.float_offset + floats.size() * sizeof(float));
+	header.file_size = header.fraction_offset + fractions.size() * sizeof(FractionRecord);
+
+	out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+	std::uint64_t position = sizeof(Header);
+
+	WriteSection(out, nodes, header.node_offset, position);
+	WriteSection(out, symbol_offsets, header.symbol_offset, position);
+	WriteSection(out, names, header.name_offset, position);
+	WriteSection(out, integers, header.integer_offset, position);
+	WriteSection(out, limbs, header.limb_offset, position);
+	WriteSection(out, floats, header.float_offset, position);
+	WriteSection(out, fractions, header.fraction_offset, position);
+}
+
+bool Save(const flat::Tree& tree, const std::string& path)
+{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+	if (!file.is_open())
+		return false;
+
+	Write(tree, file);
+	file.close();
+
+	return !file.fail();
+}
+
+bool Save(const std::unique_ptr<Expr>& expr, const std::string& path)
+{
+	return Save(flat::Tree(expr), path);
+}
+
+bool Archive::Open(const std::string& path)
+{
+	Close();
+
+	if (!Map(path) || !CheckHeader())
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void Archive::Close()
+{
+#if !defined _WIN32
+	if (m_data != nullptr && m_buffer.empty())
+		munmap(const_cast<char*>(m_data), m_size);
+#endif
+
+	m_data = nullptr;
+	m_size = 0;
+	m_buffer.clear();
+	m_buffer.shrink_to_fit();
+	m_header = nullptr;
+	m_symbols.clear();
+}
+
+bool Archive::Map(const std::string& path)
+{
+#if !defined _WIN32
+	int fd = open(path.c_str(), O_RDONLY);
+
+	if (fd < 0)
+		return false;
+
+	struct stat status;
+
+	if (fstat(fd, &status) != 0 || status.st_size < (off_t)sizeof(Header))
+	{
+		close(fd);
+		return false;
+	}
+
+	void* data = mmap(nullptr, (std::size_t)status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (data == MAP_FAILED)
+		return false;
+
+	m_data = static_cast<const char*>(data);
+	m_size = (std::size_t)status.st_size;
+#else
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+
+	if (!file.is_open())
+		return false;
+
+	m_buffer.resize((std::size_t)file.tellg());
+	file.seekg(0);
+
+	if (m_buffer.size() < sizeof(Header) || !file.read(m_buffer.data(), (std::streamsize)m_buffer.size()))
+		return false;
+
+	m_data = m_buffer.data();
+	m_size = m_buffer.size();
+#endif
+
+	return true;
+}
+
+// Only the header and the symbols are read here, the nodes and numbers are left to the page cache
+bool Archive::CheckHeader()
+{
+	const Header* header = reinterpret_cast<const Header*>(m_data);
+
+	if (!std::equal(magic, magic + 4, header->magic) || header->version != version ||
+		header->byte_order != byte_order || header->file_size != m_size)
+		return false;
+
+	auto fits = [&](std::uint64_t count, std::uint64_t offset, std::size_t record_size)
+	{
+		return offset % alignment == 0 && offset >= sizeof(Header) && offset <= m_size &&
+			count <= (m_size - offset) / record_size;
+	};
+
+	if (!fits(header->nodes, header->node_offset, sizeof(Node)) || header->nodes > (std::uint64_t)INT32_MAX ||
+		!fits(header->symbols + 1, header->symbol_offset, sizeof(std::uint64_t)) ||
+		!fits(header->name_bytes, header->name_offset, 1) ||
+		!fits(header->integers, header->integer_offset, sizeof(IntegerRecord)) ||
+		!fits(header->limbs, header->limb_offset, sizeof(std::uint32_t)) ||
+		!fits(header->floats, header->float_offset, sizeof(float)) ||
+		!fits(header->fractions, header->fraction_offset, sizeof(FractionRecord)))
+		return false;
+
+	m_header = header;
+	m_nodes = reinterpret_cast<const Node*>(m_data + header->node_offset);
+	m_symbol_offsets = reinterpret_cast<const std::uint64_t*>(m_data + header->symbol_offset);
+	m_names = m_data + header->name_offset;
+	m_integers = reinterpret_cast<const IntegerRecord*>(m_data + header->integer_offset);
+	m_limbs = reinterpret_cast<const std::uint32_t*>(m_data + header->limb_offset);
+	m_floats = reinterpret_cast<const float*>(m_data + header->float_offset);
+	m_fractions = reinterpret_cast<const FractionRecord*>(m_data + header->fraction_offset);
+
+	for (std::uint64_t s = 0; s < header->symbols; s++)
+	{
+		if (m_symbol_offsets[s] > m_symbol_offsets[s + 1] || m_symbol_offsets[s + 1] > header->name_bytes)
+			return false;
+
+		m_symbols.push_back(symbol::Intern(std::string(SymbolName((int)s))));
+	}
+
+	return true;
+}
+
+/* Checks node i against the subtrees built before it, whose sizes are on the stack, and
+*  replaces its children's sizes with its own
+*/
+bool Archive::CheckNode(flat::Index i, std::vector<int>& sizes) const
+{
+	const Node& node = m_nodes[i];
+	ExprType type = static_cast<ExprType>(node.kind);
+
+	if (node.kind > (std::uint8_t)ExprType::NIL || node.child_count < 0 || node.child_count > (int)sizes.size() ||
+		!ValidArity(type, node.generic != 0, node.child_count))
+		return false;
+
+	auto valid_integer = [&](std::uint64_t k)
+	{
+		return k < m_header->integers && m_integers[k].limb_count <= m_header->limbs &&
+			m_integers[k].first_limb <= m_header->limbs - m_integers[k].limb_count;
+	};
+
+	switch (type)
+	{
+	case ExprType::INTEGER:
+		if (node.payload < 0 || !valid_integer(node.payload))
+			return false;
+		break;
+	case ExprType::FLOAT:
+		if (node.payload < 0 || (std::uint64_t)node.payload >= m_header->floats)
+			return false;
+		break;
+	case ExprType::FRACTION:
+		if (node.payload < 0 || (std::uint64_t)node.payload >= m_header->fractions ||
+			!valid_integer(m_fractions[node.payload].numerator) || !valid_integer(m_fractions[node.payload].denominator) ||
+			Integer(m_fractions[node.payload].denominator).IsZero())
+			return false;
+		break;
+	default:
+		if (node.payload < -1 || (node.payload >= 0 && (std::uint64_t)node.payload >= m_header->symbols))
+			return false;
+		break;
+	}
+
+	int size = 1;
+
+	for (int k = 0; k < node.child_count; k++)
+	{
+		size += sizes.back();
+		sizes.pop_back();
+	}
+
+	sizes.push_back(size);
+
+	return size == node.size;
+}
+
+std::string_view Archive::SymbolName(int s) const
+{
+	return std::string_view(m_names + m_symbol_offsets[s], m_symbol_offsets[s + 1] - m_symbol_offsets[s]);
+}
+
+symbol::Id Archive::Symbol(flat::Index i) const
+{
+	return m_nodes[i].payload < 0 ? symbol::none : m_symbols[m_nodes[i].payload];
+}
+
+Rational Archive::rValue(flat::Index i) const
+{
+	const FractionRecord& fraction = m_fractions[m_nodes[i].payload];
+
+	return Rational(Integer(fraction.numerator), Integer(fraction.denominator));
+}
+
+BigInt Archive::Integer(std::uint64_t k) const
+{
+	const IntegerRecord& record = m_integers[k];
+
+	if (record.limb_count == 0)
+		return BigInt((long long)record.small);
+
+	const std::uint32_t* first = m_limbs + record.first_limb;
+
+	return BigInt(BigInt::Limbs(first, first + record.limb_count), record.negative != 0);
+}
+
+// Builds the nodes bottom up with an explicit stack, so the depth of the tree doesn't matter
+std::unique_ptr<Expr> Archive::ToExpr() const
+{
+	std::vector<std::unique_ptr<Expr>> pending;
+	std::vector<int> sizes;
+
+	for (flat::Index i = 0; i < Size(); i++)
+	{
+		if (!CheckNode(i, sizes))
+			return nullptr;
+
+		std::size_t first = pending.size() - ChildrenSize(i);
+		std::unique_ptr<Expr> expr;
+
+		switch (Kind(i))
+		{
+		case ExprType::INTEGER:
+			expr = std::make_unique<::Integer>(bValue(i));
+			break;
+		case ExprType::FLOAT:
+			expr = std::make_unique<Float>(fValue(i));
+			break;
+		case ExprType::FRACTION:
+			expr = std::make_unique<Fraction>(rValue(i));
+			break;
+		case ExprType::VARIABLE:
+			expr = std::make_unique<Var>(Symbol(i));
+			break;
+		case ExprType::PI:
+			expr = std::make_unique<Pi>();
+			break;
+		case ExprType::e:
+			expr = std::make_unique<E>();
+			break;
+		case ExprType::MUL:
+		case ExprType::ADD:
+			if (Kind(i) == ExprType::MUL)
+				expr = std::make_unique<Mul>();
+			else
+				expr = std::make_unique<Add>();
+
+			if (IsGeneric(i))
+			{
+				for (std::size_t k = first; k < pending.size(); k++)
+					expr->AddChild(std::move(pending[k]));
+			}
+			else
+			{
+				expr->SetLeft(std::move(pending[first]));
+				expr->SetRight(std::move(pending[first + 1]));
+			}
+			break;
+		case ExprType::POW:
+			expr = std::make_unique<Pow>(std::move(pending[first]), std::move(pending[first + 1]));
+			break;
+		case ExprType::FAC:
+			expr = std::make_unique<Fac>(std::move(pending[first]));
+			break;
+		case ExprType::LOG:
+			expr = std::make_unique<Log>(std::move(pending[first]), std::move(pending[first + 1]));
+			break;
+		case ExprType::LN:
+			expr = std::make_unique<Ln>(std::move(pending[first]));
+			break;
+		case ExprType::SIN:
+			expr = std::make_unique<Sin>(std::move(pending[first]));
+			break;
+		case ExprType::COS:
+			expr = std::make_unique<Cos>(std::move(pending[first]));
+			break;
+		case ExprType::TAN:
+			expr = std::make_unique<Tan>(std::move(pending[first]));
+			break;
+		case ExprType::DERIVATIVE:
+			expr = std::make_unique<Derivative>(std::move(pending[first]), Symbol(i));
+			break;
+		case ExprType::INTEGRAL:
+			expr = std::make_unique<Integral>(std::move(pending[first]), Symbol(i));
+			break;
+		default:
+			return nullptr;
+		}
+
+		pending.resize(first);
+		pending.push_back(std::move(expr));
+	}
+
+	if (pending.size() != 1)
+		return nullptr;
+
+	return std::move(pending.back());
+}
+
+flat::Tree Archive::ToTree() const
+{
+	flat::Tree tree;
+	std::vector<int> sizes;
+
+	for (flat::Index i = 0; i < Size(); i++)
+	{
+		if (!CheckNode(i, sizes))
+			return flat::Tree();
+
+		switch (Kind(i))
+		{
+		case ExprType::INTEGER:
+			tree.AddInteger(bValue(i));
+			break;
+		case ExprType::FLOAT:
+			tree.AddFloat(fValue(i));
+			break;
+		case ExprType::FRACTION:
+			tree.AddFraction(rValue(i));
+			break;
+		case ExprType::VARIABLE:
+		case ExprType::PI:
+		case ExprType::e:
+			tree.AddSymbol(Kind(i), Symbol(i));
+			break;
+		default:
+			tree.AddNode(Kind(i), ChildrenSize(i), IsGeneric(i), Symbol(i));
+			break;
+		}
+	}
+
+	if (sizes.size() != 1)
+		return flat::Tree();
+
+	return tree;
+}
+
+} // namespace archive
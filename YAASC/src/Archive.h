@@ -0,0 +1,133 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+#include "Expr.h"
+#include "FlatTree.h"
+
+namespace archive {
+
+constexpr char magic[4] = { 'Y', 'A', 'E', 'X' };
+constexpr std::uint32_t version = 1;
+constexpr std::uint32_t byte_order = 0x01020304; // Reads back differently on a machine of the other endianness
+constexpr std::size_t alignment = 8;              // Every section starts at a multiple of this
+
+/* Binary form of an expression, laid out so that a file can be mapped into memory and
+*  used in place. After the header come fixed size sections, each one an array:
+*
+*      header | nodes | symbol offsets | symbol names | integers | limbs | floats | fractions
+*
+*  Nodes are in post-order like in flat::Tree, so a node's children are the subtrees right
+*  before it. Variables point into the symbol table of the file, integers into the integer
+*  pool and the limbs of big ones into the limb pool. A fraction is a pair of integers.
+*/
+struct Header
+{
+	char magic[4];
+	std::uint32_t version;
+	std::uint32_t byte_order;
+	std::uint32_t reserved;
+	std::uint64_t file_size;
+
+	std::uint64_t nodes, node_offset;
+	std::uint64_t symbols, symbol_offset;     // symbols + 1 offsets into the names, the last one is their total size
+	std::uint64_t name_bytes, name_offset;
+	std::uint64_t integers, integer_offset;
+	std::uint64_t limbs, limb_offset;
+	std::uint64_t floats, float_offset;
+	std::uint64_t fractions, fraction_offset;
+};
+
+struct Node
+{
+	std::uint8_t kind;
+	std::uint8_t generic;
+	std::uint16_t reserved;
+	std::int32_t payload;     // Pool index of a number, symbol of a variable or of what a derivative is respect to, else -1
+	std::int32_t child_count;
+	std::int32_t size;        // Nodes in the subtree, this one included
+};
+
+struct IntegerRecord
+{
+	std::int64_t small;       // The value when limb_count is zero
+	std::uint64_t first_limb;
+	std::uint32_t limb_count;
+	std::uint32_t negative;
+};
+
+struct FractionRecord
+{
+	std::int64_t numerator;   // Indices into the integer pool
+	std::int64_t denominator;
+};
+
+void Write(const flat::Tree& tree, std::ostream& out);
+bool Save(const flat::Tree& tree, const std::string& path);
+bool Save(const std::unique_ptr<Expr>& expr, const std::string& path);
+
+/* A file written by Save(), mapped read-only. Open() only checks the header and that the
+*  sections lie inside the file, so it takes the same time for any size; the nodes are
+*  read when they are used. ToExpr() and ToTree() check each node as they go and return
+*  nothing for a damaged file instead of reading out of bounds.
+*/
+class Archive
+{
+private:
+	const char* m_data{ nullptr };
+	std::size_t m_size{ 0 };
+	std::vector<char> m_buffer;          // Holds the file where it can't be mapped
+
+	const Header* m_header{ nullptr };
+	const Node* m_nodes{ nullptr };
+	const std::uint64_t* m_symbol_offsets{ nullptr };
+	const char* m_names{ nullptr };
+	const IntegerRecord* m_integers{ nullptr };
+	const std::uint32_t* m_limbs{ nullptr };
+	const float* m_floats{ nullptr };
+	const FractionRecord* m_fractions{ nullptr };
+
+	std::vector<symbol::Id> m_symbols;   // Interned ids of the symbols of the file
+
+	bool Map(const std::string& path);
+	bool CheckHeader();
+	bool CheckNode(flat::Index i, std::vector<int>& sizes) const;
+
+public:
+	Archive() {}
+	~Archive() { Close(); }
+
+	Archive(const Archive&) = delete;
+	Archive& operator=(const Archive&) = delete;
+
+	bool Open(const std::string& path); // False when the file is missing or not an archive of this version
+	void Close();
+	bool IsOpen() const { return m_header != nullptr; }
+
+	int Size() const { return IsOpen() ? (int)m_header->nodes : 0; }
+	bool Empty() const { return Size() == 0; }
+	flat::Index Root() const { return Size() - 1; }
+
+	ExprType Kind(flat::Index i) const { return static_cast<ExprType>(m_nodes[i].kind); }
+	bool IsGeneric(flat::Index i) const { return m_nodes[i].generic != 0; }
+	int ChildrenSize(flat::Index i) const { return m_nodes[i].child_count; }
+	int SubtreeSize(flat::Index i) const { return m_nodes[i].size; }
+	flat::Index SubtreeBegin(flat::Index i) const { return i - m_nodes[i].size + 1; }
+
+	std::string_view SymbolName(int s) const;
+	symbol::Id Symbol(flat::Index i) const;
+	BigInt bValue(flat::Index i) const { return Integer(m_nodes[i].payload); }
+	Rational rValue(flat::Index i) const;
+	float fValue(flat::Index i) const { return m_floats[m_nodes[i].payload]; }
+
+	BigInt Integer(std::uint64_t k) const;
+
+	std::unique_ptr<Expr> ToExpr() const;
+	flat::Tree ToTree() const;
+};
+
+} // namespace archive
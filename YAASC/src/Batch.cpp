@@ -0,0 +1,142 @@
+#include <chrono>
+#include <iomanip>
+#include <algorithm>
+
+#if !defined _WIN32
+	#include <sys/resource.h>
+#endif
+
+#include "Batch.h"
+#include "Parallel.h"
+#include "ExprTree.h"
+#include "SymbolicTool.h"
+
+namespace batch {
+
+Stats Run(std::istream& input, std::ostream& output, int threads)
+{
+	using Clock = std::chrono::steady_clock;
+
+	Stats stats;
+	parallel::ThreadPool pool(threads); // Expressions are simplified in parallel, their terms are not
+
+	std::vector<std::string> lines;
+	std::vector<std::string> results;
+	std::string line;
+
+	Clock::time_point start = Clock::now();
+
+	while (true)
+	{
+		lines.clear();
+
+		while (static_cast<int>(lines.size()) < block_lines && std::getline(input, line))
+		{
+			if (!line.empty() && line.back() == '\r')
+				line.pop_back();
+
+			lines.push_back(std::move(line));
+		}
+
+		if (lines.empty())
+			break;
+
+		std::size_t first = stats.latencies.size();
+		results.assign(lines.size(), "");
+		stats.latencies.resize(first + lines.size());
+
+		pool.ForEach(static_cast<int>(lines.size()), [&](int i) {
+			Clock::time_point begin = Clock::now();
+			results[i] = SimplifyLine(lines[i]);
+			stats.latencies[first + i] = std::chrono::duration<double, std::micro>(Clock::now() - begin).count();
+		});
+
+		for (const std::string& result : results)
+			output << result << '\n';
+	}
+
+	output.flush();
+
+	stats.expressions = stats.latencies.size();
+	stats.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	stats.peak_memory_kb = PeakMemoryKb();
+
+	return stats;
+}
+
+// Empty lines are kept empty, so that line n of the output belongs to line n of the input
+std::string SimplifyLine(const std::string& input)
+{
+	if (input.empty())
+		return "";
+
+	if (scanner::MissingParenthesis(input))
+		return "error: missing parenthesis";
+
+	yaasc::ExprTree expr_tree(input);
+
+	{
+		NodeArena::Scope arena_scope(expr_tree.Arena());
+		yaasc::Simplify(expr_tree.Root());
+	}
+
+	std::string output = expr_tree.TreeString();
+
+	if (output == "")
+		return "error: couldn't simplify input";
+
+	return output;
+}
+
+void PrintStats(const Stats& stats, std::ostream& output)
+{
+	std::vector<double> sorted = stats.latencies;
+	std::sort(sorted.begin(), sorted.end());
+
+	double rate = stats.seconds > 0.0 ? stats.expressions / stats.seconds : 0.0;
+
+	output << std::fixed << std::setprecision(1);
+	output << "expressions: " << stats.expressions << " in " << std::setprecision(3) << stats.seconds << " s"
+	       << " (" << std::setprecision(1) << rate << " expr/s)\n";
+	output << "latency (us): p50 " << Percentile(sorted, 50.0)
+	       << ", p90 " << Percentile(sorted, 90.0)
+	       << ", p99 " << Percentile(sorted, 99.0)
+	       << ", max " << Percentile(sorted, 100.0) << '\n';
+
+	if (stats.peak_memory_kb > 0)
+		output << "peak memory: " << stats.peak_memory_kb << " KiB\n";
+	else
+		output << "peak memory: not available\n";
+}
+
+// Nearest rank percentile of sorted values
+double Percentile(const std::vector<double>& sorted, double percent)
+{
+	if (sorted.empty())
+		return 0.0;
+
+	std::size_t rank = static_cast<std::size_t>(percent / 100.0 * sorted.size() + 0.5);
+	rank = rank > 0 ? rank - 1 : 0;
+
+	return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+long PeakMemoryKb()
+{
+#if defined _WIN32
+	return 0;
+#else
+	struct rusage usage;
+
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+
+	#if defined __APPLE__
+		return usage.ru_maxrss / 1024; // Bytes on macOS
+	#else
+		return usage.ru_maxrss;
+	#endif
+#endif
+}
+
+} // namespace batch
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <ostream>
+
+namespace batch {
+
+constexpr int block_lines = 4096; // Lines that are read, simplified and written at a time
+
+struct Stats
+{
+	std::size_t expressions{ 0 };
+	double seconds{ 0.0 };
+	std::vector<double> latencies; // Microseconds per expression, in input order
+	long peak_memory_kb{ 0 }; // Zero when the platform doesn't report it
+};
+
+/* Simplifies one expression per line. The lines are read in blocks, the worker threads
+*  take expressions of a block as they become free, and the results are written in the
+*  order of the input once the whole block is done:
+*
+*      input:  x+x      output:  2x
+*              (a+b              error: missing parenthesis
+*              2*3               6
+*/
+Stats Run(std::istream& input, std::ostream& output, int threads);
+
+std::string SimplifyLine(const std::string& input);
+void PrintStats(const Stats& stats, std::ostream& output);
+
+double Percentile(const std::vector<double>& sorted, double percent);
+long PeakMemoryKb();
+
+} // namespace batch
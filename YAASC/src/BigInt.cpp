@@ -0,0 +1,943 @@
+#include <limits>
+#include <climits>
+#include <stdexcept>
+#include <algorithm>
+#include <functional>
+
+#include "BigInt.h"
+
+using Limbs = BigInt::Limbs;
+
+static const std::uint64_t limb_base = 1ULL << 32;
+
+int BigInt::karatsuba_threshold = 64;
+int BigInt::toom3_threshold = 700;
+int BigInt::division_threshold = 1400;
+
+static Limbs MulMagnitudes(const Limbs& a, const Limbs& b);
+
+static void Trim(Limbs& limbs)
+{
+	while (!limbs.empty() && limbs.back() == 0)
+		limbs.pop_back();
+}
+
+static Limbs ToLimbs(std::uint64_t value)
+{
+	Limbs limbs;
+
+	while (value != 0)
+	{
+		limbs.push_back(static_cast<std::uint32_t>(value));
+		value >>= 32;
+	}
+
+	return limbs;
+}
+
+static std::uint64_t AbsSmall(std::int64_t value)
+{
+	return value < 0 ? static_cast<std::uint64_t>(-(value + 1)) + 1 : static_cast<std::uint64_t>(value);
+}
+
+static int CompareMagnitudes(const Limbs& a, const Limbs& b)
+{
+	if (a.size() != b.size())
+		return a.size() < b.size() ? -1 : 1;
+
+	for (std::size_t i = a.size(); i-- > 0;)
+	{
+		if (a[i] != b[i])
+			return a[i] < b[i] ? -1 : 1;
+	}
+
+	return 0;
+}
+
+static Limbs AddMagnitudes(const Limbs& a, const Limbs& b)
+{
+	const Limbs& longer = a.size() >= b.size() ? a : b;
+	const Limbs& shorter = a.size() >= b.size() ? b : a;
+	Limbs sum(longer.size() + 1, 0);
+	std::uint64_t carry = 0;
+
+	for (std::size_t i = 0; i < longer.size(); i++)
+	{
+		carry += longer[i];
+
+		if (i < shorter.size())
+			carry += shorter[i];
+
+		sum[i] = static_cast<std::uint32_t>(carry);
+		carry >>= 32;
+	}
+
+	sum[longer.size()] = static_cast<std::uint32_t>(carry);
+	Trim(sum);
+
+	return sum;
+}
+
+// |a| >= |b|
+static Limbs SubMagnitudes(const Limbs& a, const Limbs& b)
+{
+	Limbs difference(a.size(), 0);
+	std::int64_t borrow = 0;
+
+	for (std::size_t i = 0; i < a.size(); i++)
+	{
+		std::int64_t value = static_cast<std::int64_t>(a[i]) - borrow - (i < b.size() ? b[i] : 0);
+		borrow = value < 0 ? 1 : 0;
+		difference[i] = static_cast<std::uint32_t>(value + borrow * static_cast<std::int64_t>(limb_base));
+	}
+
+	Trim(difference);
+
+	return difference;
+}
+
+static Limbs MulSchoolbook(const Limbs& a, const Limbs& b)
+{
+	Limbs product(a.size() + b.size(), 0);
+
+	for (std::size_t i = 0; i < a.size(); i++)
+	{
+		std::uint64_t carry = 0;
+
+		for (std::size_t j = 0; j < b.size(); j++)
+		{
+			carry += static_cast<std::uint64_t>(a[i]) * b[j] + product[i + j];
+			product[i + j] = static_cast<std::uint32_t>(carry);
+			carry >>= 32;
+		}
+
+		product[i + b.size()] = static_cast<std::uint32_t>(carry);
+	}
+
+	Trim(product);
+
+	return product;
+}
+
+// Limbs [from, from + count) of a
+static Limbs Slice(const Limbs& a, std::size_t from, std::size_t count)
+{
+	if (from >= a.size())
+		return Limbs();
+
+	Limbs slice(a.begin() + from, a.begin() + std::min(a.size(), from + count));
+	Trim(slice);
+
+	return slice;
+}
+
+// Multiplies by 2^(32 * count)
+static Limbs ShiftLimbs(Limbs a, std::size_t count)
+{
+	if (!a.empty())
+		a.insert(a.begin(), count, 0);
+
+	return a;
+}
+
+// sum += x * 2^(32 * shift)
+static void AddShifted(Limbs& sum, const Limbs& x, std::size_t shift)
+{
+	if (sum.size() < x.size() + shift + 1)
+		sum.resize(x.size() + shift + 1, 0);
+
+	std::uint64_t carry = 0;
+	std::size_t i = 0;
+
+	for (; i < x.size(); i++)
+	{
+		carry += static_cast<std::uint64_t>(sum[i + shift]) + x[i];
+		sum[i + shift] = static_cast<std::uint32_t>(carry);
+		carry >>= 32;
+	}
+
+	for (i += shift; carry != 0; i++)
+	{
+		if (i == sum.size())
+			sum.push_back(0);
+
+		carry += sum[i];
+		sum[i] = static_cast<std::uint32_t>(carry);
+		carry >>= 32;
+	}
+
+	Trim(sum);
+}
+
+// a = a0 + a1x, b = b0 + b1x: ab = z0 + ((a0 + a1)(b0 + b1) - z0 - z2)x + z2x^2, three half size products instead of four
+static Limbs MulKaratsuba(const Limbs& a, const Limbs& b)
+{
+	std::size_t half = (a.size() + 1) / 2;
+	Limbs a0 = Slice(a, 0, half);
+	Limbs a1 = Slice(a, half, a.size());
+	Limbs b0 = Slice(b, 0, half);
+	Limbs b1 = Slice(b, half, b.size());
+
+	Limbs z0 = MulMagnitudes(a0, b0);
+	Limbs z2 = MulMagnitudes(a1, b1);
+	Limbs z1 = MulMagnitudes(AddMagnitudes(a0, a1), AddMagnitudes(b0, b1));
+	z1 = SubMagnitudes(SubMagnitudes(z1, z0), z2);
+
+	Limbs product = z0;
+	AddShifted(product, z1, half);
+	AddShifted(product, z2, 2 * half);
+
+	return product;
+}
+
+/* Toom-3: both factors are split into three parts and seen as polynomials
+*  in x = 2^(32k). The product polynomial is evaluated at 0, 1, -1, -2 and
+*  infinity with five products of a third of the size, and its coefficients
+*  are interpolated back (sequence by Bodrato):
+*
+*      r(x) = r0 + r1x + r2x^2 + r3x^3 + r4x^4
+*/
+static Limbs MulToom3(const Limbs& a, const Limbs& b)
+{
+	std::size_t k = (a.size() + 2) / 3;
+	BigInt a0(Slice(a, 0, k), false), a1(Slice(a, k, k), false), a2(Slice(a, 2 * k, a.size()), false);
+	BigInt b0(Slice(b, 0, k), false), b1(Slice(b, k, k), false), b2(Slice(b, 2 * k, b.size()), false);
+
+	BigInt a_sum = a0 + a2;
+	BigInt b_sum = b0 + b2;
+	BigInt a_neg = a_sum - a1;
+	BigInt b_neg = b_sum - b1;
+
+	BigInt r0 = a0 * b0;
+	BigInt r_one = (a_sum + a1) * (b_sum + b1);
+	BigInt r_neg_one = a_neg * b_neg;
+	BigInt r_neg_two = ((a_neg + a2) * 2 - a0) * ((b_neg + b2) * 2 - b0);
+	BigInt r4 = a2 * b2;
+
+	BigInt r3 = (r_neg_two - r_one) / 3;
+	BigInt r1 = (r_one - r_neg_one) / 2;
+	BigInt r2 = r_neg_one - r0;
+	r3 = (r2 - r3) / 2 + r4 * 2;
+	r2 = r2 + r1 - r4;
+	r1 = r1 - r3;
+
+	Limbs product = r0.Magnitude();
+	AddShifted(product, r1.Magnitude(), k);
+	AddShifted(product, r2.Magnitude(), 2 * k);
+	AddShifted(product, r3.Magnitude(), 3 * k);
+	AddShifted(product, r4.Magnitude(), 4 * k);
+
+	return product;
+}
+
+static Limbs MulMagnitudes(const Limbs& a, const Limbs& b)
+{
+	if (a.size() < b.size())
+		return MulMagnitudes(b, a);
+
+	if (b.empty())
+		return Limbs();
+
+	if ((int)b.size() < BigInt::karatsuba_threshold)
+		return MulSchoolbook(a, b);
+
+	// Unbalanced factors are multiplied in pieces of the shorter one
+	if (a.size() >= 2 * b.size())
+	{
+		Limbs product;
+
+		for (std::size_t i = 0; i < a.size(); i += b.size())
+			AddShifted(product, MulMagnitudes(Slice(a, i, b.size()), b), i);
+
+		return product;
+	}
+
+	if ((int)b.size() < BigInt::toom3_threshold)
+		return MulKaratsuba(a, b);
+
+	return MulToom3(a, b);
+}
+
+// Divides in place and returns the remainder
+static std::uint32_t DivSingleLimb(Limbs& a, std::uint32_t divisor)
+{
+	std::uint64_t remainder = 0;
+
+	for (std::size_t i = a.size(); i-- > 0;)
+	{
+		std::uint64_t current = (remainder << 32) | a[i];
+		a[i] = static_cast<std::uint32_t>(current / divisor);
+		remainder = current % divisor;
+	}
+
+	Trim(a);
+
+	return static_cast<std::uint32_t>(remainder);
+}
+
+static int LeadingZeros(std::uint32_t value)
+{
+	int count = 0;
+
+	while ((value & 0x80000000u) == 0)
+	{
+		value <<= 1;
+		count++;
+	}
+
+	return count;
+}
+
+// Long division (Knuth, TAOCP vol. 2, algorithm D)
+static void DivSchoolbook(const Limbs& a, const Limbs& b, Limbs& quotient, Limbs& remainder)
+{
+	if (CompareMagnitudes(a, b) < 0)
+	{
+		quotient.clear();
+		remainder = a;
+		return;
+	}
+
+	if (b.size() == 1)
+	{
+		quotient = a;
+		std::uint32_t rest = DivSingleLimb(quotient, b[0]);
+		remainder = rest != 0 ? Limbs{ rest } : Limbs();
+		return;
+	}
+
+	// Normalizing makes the top limb of the divisor large, so each quotient digit estimate is off by at most two
+	int shift = LeadingZeros(b.back());
+	std::size_t n = b.size();
+	std::size_t m = a.size() - n;
+	Limbs u(a.size() + 1, 0);
+	Limbs v(n, 0);
+
+	for (std::size_t i = n; i-- > 0;)
+		v[i] = (b[i] << shift) | (shift != 0 && i > 0 ? b[i - 1] >> (32 - shift) : 0);
+
+	u[a.size()] = shift != 0 ? a.back() >> (32 - shift) : 0;
+
+	for (std::size_t i = a.size(); i-- > 0;)
+		u[i] = (a[i] << shift) | (shift != 0 && i > 0 ? a[i - 1] >> (32 - shift) : 0);
+
+	quotient.assign(m + 1, 0);
+
+	for (std::size_t j = m + 1; j-- > 0;)
+	{
+		std::uint64_t numerator = (static_cast<std::uint64_t>(u[j + n]) << 32) | u[j + n - 1];
+		std::uint64_t estimate = numerator / v[n - 1];
+		std::uint64_t rest = numerator % v[n - 1];
+
+		while (estimate >= limb_base || estimate * v[n - 2] > ((rest << 32) | u[j + n - 2]))
+		{
+			estimate--;
+			rest += v[n - 1];
+
+			if (rest >= limb_base)
+				break;
+		}
+
+		std::int64_t borrow = 0;
+		std::uint64_t carry = 0;
+
+		for (std::size_t i = 0; i < n; i++)
+		{
+			carry += estimate * v[i];
+			std::int64_t value = static_cast<std::int64_t>(u[i + j]) - borrow - static_cast<std::int64_t>(carry & 0xffffffffu);
+			carry >>= 32;
+			borrow = value < 0 ? 1 : 0;
+			u[i + j] = static_cast<std::uint32_t>(value + borrow * static_cast<std::int64_t>(limb_base));
+		}
+
+		std::int64_t top = static_cast<std::int64_t>(u[j + n]) - borrow - static_cast<std::int64_t>(carry);
+		u[j + n] = static_cast<std::uint32_t>(top);
+
+		// Estimate was one too large, add the divisor back
+		if (top < 0)
+		{
+			estimate--;
+			carry = 0;
+
+			for (std::size_t i = 0; i < n; i++)
+			{
+				carry += static_cast<std::uint64_t>(u[i + j]) + v[i];
+				u[i + j] = static_cast<std::uint32_t>(carry);
+				carry >>= 32;
+			}
+
+			u[j + n] += static_cast<std::uint32_t>(carry);
+		}
+
+		quotient[j] = static_cast<std::uint32_t>(estimate);
+	}
+
+	Trim(quotient);
+
+	remainder.assign(n, 0);
+
+	for (std::size_t i = 0; i < n; i++)
+		remainder[i] = (u[i] >> shift) | (shift != 0 ? u[i + 1] << (32 - shift) : 0);
+
+	Trim(remainder);
+}
+
+static void ShiftRight(Limbs& limbs, int bits)
+{
+	std::size_t limb_shift = bits / 32;
+	int bit_shift = bits % 32;
+
+	if (limb_shift >= limbs.size())
+	{
+		limbs.clear();
+		return;
+	}
+
+	limbs.erase(limbs.begin(), limbs.begin() + limb_shift);
+
+	if (bit_shift != 0)
+	{
+		for (std::size_t i = 0; i < limbs.size(); i++)
+		{
+			limbs[i] >>= bit_shift;
+
+			if (i + 1 < limbs.size())
+				limbs[i] |= limbs[i + 1] << (32 - bit_shift);
+		}
+	}
+
+	Trim(limbs);
+}
+
+static void ShiftLeft(Limbs& limbs, int bits)
+{
+	if (limbs.empty())
+		return;
+
+	std::size_t limb_shift = bits / 32;
+	int bit_shift = bits % 32;
+
+	limbs.insert(limbs.begin(), limb_shift, 0);
+
+	if (bit_shift != 0)
+	{
+		limbs.push_back(0);
+
+		for (std::size_t i = limbs.size() - 1; i > limb_shift; i--)
+			limbs[i] = (limbs[i] << bit_shift) | (limbs[i - 1] >> (32 - bit_shift));
+
+		limbs[limb_shift] <<= bit_shift;
+	}
+
+	Trim(limbs);
+}
+
+static int BitLength(const Limbs& limbs)
+{
+	if (limbs.empty())
+		return 0;
+
+	return (int)limbs.size() * 32 - LeadingZeros(limbs.back());
+}
+
+static void DivTwoByOne(const Limbs& a, const Limbs& b, Limbs& quotient, Limbs& remainder);
+
+// Divides [a12, a3] (3 halves) by b = [b1, b2] (2 halves), where a12 < b * 2^(32 * half)
+static void DivThreeHalvesByTwo(const Limbs& a12, const Limbs& a3, const Limbs& b, const Limbs& b1, const Limbs& b2,
+                                Limbs& quotient, Limbs& remainder)
+{
+	std::size_t half = b.size() / 2;
+	Limbs rest;
+
+	if (CompareMagnitudes(Slice(a12, half, half), b1) < 0)
+		DivTwoByOne(a12, b1, quotient, rest);
+	else
+	{
+		// Top halves are equal, so the quotient estimate is the largest half size number
+		quotient.assign(half, 0xffffffffu);
+		rest = AddMagnitudes(Slice(a12, 0, half), b1);
+	}
+
+	Limbs product = MulMagnitudes(quotient, b2);
+	Limbs estimate = ShiftLimbs(rest, half);
+	AddShifted(estimate, a3, 0);
+
+	// Estimate is at most two too large
+	while (CompareMagnitudes(estimate, product) < 0)
+	{
+		estimate = AddMagnitudes(estimate, b);
+		quotient = SubMagnitudes(quotient, Limbs{ 1 });
+	}
+
+	remainder = SubMagnitudes(estimate, product);
+}
+
+// Divides a < b * 2^(32n) by b of n limbs whose top bit is set
+static void DivTwoByOne(const Limbs& a, const Limbs& b, Limbs& quotient, Limbs& remainder)
+{
+	std::size_t n = b.size();
+
+	if (n % 2 != 0 || (int)n < BigInt::division_threshold)
+	{
+		DivSchoolbook(a, b, quotient, remainder);
+		return;
+	}
+
+	std::size_t half = n / 2;
+	Limbs b1 = Slice(b, half, half);
+	Limbs b2 = Slice(b, 0, half);
+	Limbs high_quotient;
+	Limbs rest;
+
+	DivThreeHalvesByTwo(Slice(a, 2 * half, n), Slice(a, half, half), b, b1, b2, high_quotient, rest);
+	DivThreeHalvesByTwo(rest, Slice(a, 0, half), b, b1, b2, quotient, remainder);
+	AddShifted(quotient, high_quotient, half);
+}
+
+/* Recursive division (Burnikel and Ziegler). The divisor is padded to
+*  n = j * 2^k limbs and normalized, the dividend is cut into blocks of n
+*  limbs, and each two blocks are divided by splitting them into halves,
+*  which turns the division into multiplications of half the size.
+*/
+static void DivBurnikelZiegler(const Limbs& a, const Limbs& b, Limbs& quotient, Limbs& remainder)
+{
+	std::size_t block_count = 1;
+
+	while (block_count * BigInt::division_threshold < b.size())
+		block_count *= 2;
+
+	std::size_t n = (b.size() + block_count - 1) / block_count * block_count;
+	int shift = (int)n * 32 - BitLength(b);
+
+	Limbs divisor = b;
+	Limbs dividend = a;
+	ShiftLeft(divisor, shift);
+	ShiftLeft(dividend, shift);
+
+	// Top bit of the dividend must be free, so that the first two blocks are smaller than divisor * 2^(32n)
+	std::size_t t = std::max<std::size_t>(2, (BitLength(dividend) + 32 * n) / (32 * n));
+	Limbs current = Slice(dividend, (t - 2) * n, 2 * n);
+	Limbs block_quotient;
+	Limbs block_remainder;
+
+	quotient.clear();
+
+	for (std::size_t i = t - 2; ; i--)
+	{
+		DivTwoByOne(current, divisor, block_quotient, block_remainder);
+		AddShifted(quotient, block_quotient, i * n);
+
+		if (i == 0)
+			break;
+
+		current = ShiftLimbs(block_remainder, n);
+		AddShifted(current, Slice(dividend, (i - 1) * n, n), 0);
+	}
+
+	remainder = block_remainder;
+	ShiftRight(remainder, shift);
+}
+
+static void DivMagnitudes(const Limbs& a, const Limbs& b, Limbs& quotient, Limbs& remainder)
+{
+	if ((int)b.size() < BigInt::division_threshold || a.size() < b.size() + BigInt::division_threshold)
+		DivSchoolbook(a, b, quotient, remainder);
+	else
+		DivBurnikelZiegler(a, b, quotient, remainder);
+}
+
+static std::uint64_t BinaryGcd(std::uint64_t a, std::uint64_t b)
+{
+	if (a == 0)
+		return b;
+
+	if (b == 0)
+		return a;
+
+	int shift = 0;
+
+	while (((a | b) & 1) == 0)
+	{
+		a >>= 1;
+		b >>= 1;
+		shift++;
+	}
+
+	while ((a & 1) == 0)
+		a >>= 1;
+
+	while (b != 0)
+	{
+		while ((b & 1) == 0)
+			b >>= 1;
+
+		if (a > b)
+			std::swap(a, b);
+
+		b -= a;
+	}
+
+	return a << shift;
+}
+
+BigInt::BigInt(Limbs magnitude, bool negative)
+{
+	Trim(magnitude);
+
+	// Use the inline form whenever the value fits in it
+	if (magnitude.size() <= 2)
+	{
+		std::uint64_t value = 0;
+
+		for (std::size_t i = magnitude.size(); i-- > 0;)
+			value = (value << 32) | magnitude[i];
+
+		if (!negative && value <= static_cast<std::uint64_t>(INT64_MAX))
+		{
+			m_small = static_cast<std::int64_t>(value);
+			return;
+		}
+		else if (negative && value <= static_cast<std::uint64_t>(INT64_MAX) + 1)
+		{
+			m_small = value == static_cast<std::uint64_t>(INT64_MAX) + 1 ? INT64_MIN : -static_cast<std::int64_t>(value);
+			return;
+		}
+	}
+
+	m_limbs = std::move(magnitude);
+	m_negative = negative;
+}
+
+Limbs BigInt::Magnitude() const
+{
+	if (IsSmall())
+		return ToLimbs(AbsSmall(m_small));
+
+	return m_limbs;
+}
+
+BigInt BigInt::FromString(const std::string& digits)
+{
+	std::size_t i = 0;
+	bool negative = false;
+
+	if (i < digits.size() && (digits[i] == '-' || digits[i] == '+'))
+	{
+		negative = digits[i] == '-';
+		i++;
+	}
+
+	Limbs magnitude;
+
+	// Nine decimal digits at a time fit in one limb
+	while (i < digits.size())
+	{
+		std::size_t count = std::min<std::size_t>(9, digits.size() - i);
+		std::uint64_t chunk = std::stoull(digits.substr(i, count));
+		std::uint64_t scale = 1;
+
+		for (std::size_t k = 0; k < count; k++)
+			scale *= 10;
+
+		std::uint64_t carry = chunk;
+
+		for (std::uint32_t& limb : magnitude)
+		{
+			carry += static_cast<std::uint64_t>(limb) * scale;
+			limb = static_cast<std::uint32_t>(carry);
+			carry >>= 32;
+		}
+
+		if (carry != 0)
+			magnitude.push_back(static_cast<std::uint32_t>(carry));
+
+		i += count;
+	}
+
+	return BigInt(std::move(magnitude), negative);
+}
+
+int BigInt::Sign() const
+{
+	if (IsSmall())
+		return m_small < 0 ? -1 : (m_small > 0 ? 1 : 0);
+
+	return m_negative ? -1 : 1;
+}
+
+bool BigInt::FitsInt() const
+{
+	return IsSmall() && m_small >= INT_MIN && m_small <= INT_MAX;
+}
+
+int BigInt::ToInt() const
+{
+	if (FitsInt())
+		return static_cast<int>(m_small);
+
+	return Sign() < 0 ? INT_MIN : INT_MAX;
+}
+
+double BigInt::ToDouble() const
+{
+	if (IsSmall())
+		return static_cast<double>(m_small);
+
+	double value = 0.0;
+
+	for (std::size_t i = m_limbs.size(); i-- > 0;)
+		value = value * static_cast<double>(limb_base) + m_limbs[i];
+
+	return m_negative ? -value : value;
+}
+
+std::string BigInt::ToString() const
+{
+	if (IsSmall())
+		return std::to_string(m_small);
+
+	Limbs magnitude = m_limbs;
+	std::vector<std::uint32_t> chunks;
+
+	while (!magnitude.empty())
+		chunks.push_back(DivSingleLimb(magnitude, 1000000000u));
+
+	std::string digits = m_negative ? "-" : "";
+	digits += std::to_string(chunks.back());
+
+	for (std::size_t i = chunks.size() - 1; i-- > 0;)
+	{
+		std::string chunk = std::to_string(chunks[i]);
+		digits += std::string(9 - chunk.size(), '0') + chunk;
+	}
+
+	return digits;
+}
+
+// Small values hash like long long, so integers hash the same regardless of their width.
+// A value is big only when it doesn't fit the inline form, so its limbs are canonical.
+std::size_t BigInt::Hash() const
+{
+	if (IsSmall())
+		return std::hash<long long>()(m_small);
+
+	std::size_t seed = std::hash<bool>()(m_negative);
+
+	for (std::uint32_t limb : m_limbs)
+		seed ^= std::hash<std::uint32_t>()(limb) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+
+	return seed;
+}
+
+BigInt BigInt::Pow(unsigned exponent) const
+{
+	BigInt result(1);
+	BigInt base = *this;
+
+	while (exponent != 0)
+	{
+		if (exponent & 1)
+			result *= base;
+
+		exponent >>= 1;
+
+		if (exponent != 0)
+			base *= base;
+	}
+
+	return result;
+}
+
+BigInt BigInt::operator-() const
+{
+	if (IsSmall() && m_small != INT64_MIN)
+		return BigInt(static_cast<long long>(-m_small));
+
+	return BigInt(Magnitude(), Sign() > 0);
+}
+
+BigInt operator+(const BigInt& a, const BigInt& b)
+{
+	if (a.IsSmall() && b.IsSmall())
+	{
+		std::int64_t x = a.m_small;
+		std::int64_t y = b.m_small;
+
+		if (!((y > 0 && x > INT64_MAX - y) || (y < 0 && x < INT64_MIN - y)))
+			return BigInt(static_cast<long long>(x + y));
+	}
+
+	bool negative_a = a.Sign() < 0;
+	bool negative_b = b.Sign() < 0;
+	Limbs magnitude_a = a.Magnitude();
+	Limbs magnitude_b = b.Magnitude();
+
+	if (negative_a == negative_b)
+		return BigInt(AddMagnitudes(magnitude_a, magnitude_b), negative_a);
+
+	if (CompareMagnitudes(magnitude_a, magnitude_b) >= 0)
+		return BigInt(SubMagnitudes(magnitude_a, magnitude_b), negative_a);
+
+	return BigInt(SubMagnitudes(magnitude_b, magnitude_a), negative_b);
+}
+
+BigInt operator-(const BigInt& a, const BigInt& b)
+{
+	return a + (-b);
+}
+
+BigInt operator*(const BigInt& a, const BigInt& b)
+{
+	if (a.IsSmall() && b.IsSmall())
+	{
+		std::int64_t x = a.m_small;
+		std::int64_t y = b.m_small;
+
+		// Products of values that fit in 32 bits can't overflow
+		if (x >= INT32_MIN && x <= INT32_MAX && y >= INT32_MIN && y <= INT32_MAX)
+			return BigInt(static_cast<long long>(x * y));
+	}
+
+	return BigInt(MulMagnitudes(a.Magnitude(), b.Magnitude()), (a.Sign() < 0) != (b.Sign() < 0));
+}
+
+void DivMod(const BigInt& a, const BigInt& b, BigInt& quotient, BigInt& remainder)
+{
+	if (b.IsZero())
+		throw std::domain_error("division by zero");
+
+	if (a.IsSmall() && b.IsSmall() && !(a.m_small == INT64_MIN && b.m_small == -1))
+	{
+		quotient = BigInt(static_cast<long long>(a.m_small / b.m_small));
+		remainder = BigInt(static_cast<long long>(a.m_small % b.m_small));
+		return;
+	}
+
+	Limbs quotient_limbs;
+	Limbs remainder_limbs;
+	DivMagnitudes(a.Magnitude(), b.Magnitude(), quotient_limbs, remainder_limbs);
+
+	quotient = BigInt(std::move(quotient_limbs), (a.Sign() < 0) != (b.Sign() < 0));
+	remainder = BigInt(std::move(remainder_limbs), a.Sign() < 0);
+}
+
+BigInt operator/(const BigInt& a, const BigInt& b)
+{
+	BigInt quotient;
+	BigInt remainder;
+	DivMod(a, b, quotient, remainder);
+
+	return quotient;
+}
+
+BigInt operator%(const BigInt& a, const BigInt& b)
+{
+	BigInt quotient;
+	BigInt remainder;
+	DivMod(a, b, quotient, remainder);
+
+	return remainder;
+}
+
+int Compare(const BigInt& a, const BigInt& b)
+{
+	if (a.IsSmall() && b.IsSmall())
+		return a.m_small < b.m_small ? -1 : (a.m_small > b.m_small ? 1 : 0);
+
+	int sign_a = a.Sign();
+	int sign_b = b.Sign();
+
+	if (sign_a != sign_b)
+		return sign_a < sign_b ? -1 : 1;
+
+	int magnitude_order = CompareMagnitudes(a.Magnitude(), b.Magnitude());
+
+	return sign_a < 0 ? -magnitude_order : magnitude_order;
+}
+
+BigInt Abs(const BigInt& value)
+{
+	return value.Sign() < 0 ? -value : value;
+}
+
+static std::uint64_t ToSmall(const Limbs& limbs)
+{
+	std::uint64_t value = 0;
+
+	for (std::size_t i = std::min<std::size_t>(limbs.size(), 2); i-- > 0;)
+		value = (value << 32) | limbs[i];
+
+	return value;
+}
+
+/* Lehmer's GCD: Euclid's steps are simulated on the leading 32 bits of
+*  both numbers, collecting them into a matrix of single word cofactors,
+*  which is then applied to the full numbers at once:
+*
+*      u' = Au + Bv
+*      v' = Cu + Dv
+*
+*  Once both numbers fit in 64 bits the binary GCD finishes the job.
+*/
+BigInt Gcd(const BigInt& a, const BigInt& b)
+{
+	if (a.IsSmall() && b.IsSmall())
+		return BigInt(ToLimbs(BinaryGcd(AbsSmall(a.m_small), AbsSmall(b.m_small))), false);
+
+	BigInt u = Abs(a);
+	BigInt v = Abs(b);
+
+	if (u < v)
+		std::swap(u, v);
+
+	while (!v.IsSmall() || !u.IsSmall())
+	{
+		if (v.IsZero())
+			return u;
+
+		Limbs u_limbs = u.Magnitude();
+		Limbs v_limbs = v.Magnitude();
+		int shift = std::max(0, BitLength(u_limbs) - 32);
+		ShiftRight(u_limbs, shift);
+		ShiftRight(v_limbs, shift);
+
+		std::int64_t u_top = static_cast<std::int64_t>(ToSmall(u_limbs));
+		std::int64_t v_top = static_cast<std::int64_t>(ToSmall(v_limbs));
+		std::int64_t A = 1, B = 0, C = 0, D = 1;
+
+		while (v_top + C != 0 && v_top + D != 0)
+		{
+			std::int64_t q = (u_top + A) / (v_top + C);
+
+			if (q != (u_top + B) / (v_top + D))
+				break;
+
+			std::int64_t t = A - q * C;
+			A = C;
+			C = t;
+			t = B - q * D;
+			B = D;
+			D = t;
+			t = u_top - q * v_top;
+			u_top = v_top;
+			v_top = t;
+		}
+
+		if (B == 0)
+		{
+			// No single word step was certain, take one full step
+			BigInt r = u % v;
+			u = std::move(v);
+			v = std::move(r);
+		}
+		else
+		{
+			BigInt next_u = u * BigInt(static_cast<long long>(A)) + v * BigInt(static_cast<long long>(B));
+			BigInt next_v = u * BigInt(static_cast<long long>(C)) + v * BigInt(static_cast<long long>(D));
+			u = std::move(next_u);
+			v = std::move(next_v);
+		}
+	}
+
+	return BigInt(ToLimbs(BinaryGcd(AbsSmall(u.m_small), AbsSmall(v.m_small))), false);
+}
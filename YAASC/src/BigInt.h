@@ -0,0 +1,82 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/* Signed integer of any size. Values that fit in 64 bits are stored inline
+*  and computed with machine arithmetic; only when a result overflows is its
+*  magnitude moved to heap allocated 32-bit limbs:
+*
+*      small: m_small = -42, m_limbs = {}
+*      big:   m_negative = true, m_limbs = { low, ..., high }
+*
+*  A value always uses the small form when it fits, so two equal values
+*  have the same representation.
+*/
+class BigInt
+{
+public:
+	using Limbs = std::vector<std::uint32_t>; // Least significant limb first
+
+	// Limb counts where the faster algorithms take over, measured with bench/BigIntBench.cpp
+	static int karatsuba_threshold;
+	static int toom3_threshold;
+	static int division_threshold;
+
+private:
+	std::int64_t m_small{ 0 };
+	Limbs m_limbs;
+	bool m_negative{ false };
+
+public:
+	BigInt() {}
+	BigInt(int value) : m_small(value) {}
+	BigInt(long long value) : m_small(value) {}
+	BigInt(Limbs magnitude, bool negative);
+
+	static BigInt FromString(const std::string& digits);
+
+	Limbs Magnitude() const;
+
+	bool IsSmall() const { return m_limbs.empty(); }
+	std::int64_t Small() const { return m_small; }
+
+	int Sign() const;
+	bool IsZero() const { return IsSmall() && m_small == 0; }
+	bool IsEven() const { return IsSmall() ? (m_small & 1) == 0 : (m_limbs[0] & 1) == 0; }
+	bool FitsInt() const;
+
+	int ToInt() const; // Saturates to the int range
+	double ToDouble() const;
+	std::string ToString() const;
+	std::size_t Hash() const;
+
+	BigInt Pow(unsigned exponent) const;
+
+	BigInt operator-() const;
+	BigInt& operator+=(const BigInt& other) { return *this = *this + other; }
+	BigInt& operator-=(const BigInt& other) { return *this = *this - other; }
+	BigInt& operator*=(const BigInt& other) { return *this = *this * other; }
+	BigInt& operator/=(const BigInt& other) { return *this = *this / other; }
+
+	friend BigInt operator+(const BigInt& a, const BigInt& b);
+	friend BigInt operator-(const BigInt& a, const BigInt& b);
+	friend BigInt operator*(const BigInt& a, const BigInt& b);
+	friend BigInt operator/(const BigInt& a, const BigInt& b);
+	friend BigInt operator%(const BigInt& a, const BigInt& b);
+
+	// Truncating division, like the built-in operators
+	friend void DivMod(const BigInt& a, const BigInt& b, BigInt& quotient, BigInt& remainder);
+
+	friend int Compare(const BigInt& a, const BigInt& b);
+	friend BigInt Abs(const BigInt& value);
+	friend BigInt Gcd(const BigInt& a, const BigInt& b);
+};
+
+inline bool operator==(const BigInt& a, const BigInt& b) { return Compare(a, b) == 0; }
+inline bool operator!=(const BigInt& a, const BigInt& b) { return Compare(a, b) != 0; }
+inline bool operator<(const BigInt& a, const BigInt& b) { return Compare(a, b) < 0; }
+inline bool operator<=(const BigInt& a, const BigInt& b) { return Compare(a, b) <= 0; }
+inline bool operator>(const BigInt& a, const BigInt& b) { return Compare(a, b) > 0; }
+inline bool operator>=(const BigInt& a, const BigInt& b) { return Compare(a, b) >= 0; }
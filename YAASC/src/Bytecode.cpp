@@ -0,0 +1,269 @@
+#include <cmath>
+
+#include "Bytecode.h"
+
+namespace bytecode {
+
+constexpr double pi = 3.14159265358979323846;
+constexpr double e = 2.71828182845904523536;
+
+static double Unary(Op op, double x)
+{
+	switch (op)
+	{
+	case Op::NEG: return -x;
+	case Op::SIN: return std::sin(x);
+	case Op::COS: return std::cos(x);
+	case Op::TAN: return std::tan(x);
+	case Op::LN:  return std::log(x);
+	case Op::FAC: return std::tgamma(x + 1.0);
+	default:
+		break;
+	}
+
+	return x;
+}
+
+Program::Program(const std::unique_ptr<Expr>& expr)
+{
+	if (!expr || !Compile(expr, 0))
+	{
+		m_code.clear();
+		m_constants.clear();
+		m_variables.clear();
+		m_registers = 0;
+	}
+}
+
+std::uint32_t Program::Constant(double value)
+{
+	m_constants.push_back(value);
+	return (std::uint32_t)m_constants.size() - 1;
+}
+
+// Programs use a handful of variables, a linear search is cheaper than a map
+std::uint32_t Program::Slot(symbol::Id id)
+{
+	int slot = SlotOf(id);
+
+	if (slot != -1)
+		return (std::uint32_t)slot;
+
+	m_variables.push_back(id);
+	return (std::uint32_t)m_variables.size() - 1;
+}
+
+int Program::SlotOf(symbol::Id id) const
+{
+	for (std::size_t k = 0; k < m_variables.size(); k++)
+	{
+		if (m_variables[k] == id)
+			return (int)k;
+	}
+
+	return -1;
+}
+
+void Program::Emit(Op op, std::uint32_t d, std::uint32_t a, std::uint32_t b)
+{
+	m_code.push_back({ op, d, a, b });
+
+	if (d + 1 > m_registers)
+		m_registers = d + 1;
+}
+
+// Leaves the value of expr in register r, using only registers above r for the operands
+bool Program::Compile(const std::unique_ptr<Expr>& expr, std::uint32_t r)
+{
+	switch (expr->ExpressionType())
+	{
+	case ExprType::INTEGER:
+	case ExprType::FLOAT:
+	case ExprType::FRACTION:
+		Emit(Op::CONST, r, Constant(NumericValue(expr)));
+		return true;
+	case ExprType::VARIABLE:
+		Emit(Op::LOAD, r, Slot(expr->Symbol()));
+		return true;
+	case ExprType::PI:
+		Emit(Op::CONST, r, Constant(pi));
+		return true;
+	case ExprType::e:
+		Emit(Op::CONST, r, Constant(e));
+		return true;
+	case ExprType::ADD:
+	case ExprType::MUL:
+		return CompileOperands(expr, r);
+	case ExprType::POW:
+		if (!Compile(expr->Left(), r))
+			return false;
+
+		if (expr->Right()->IsOne()) // Variables are parsed as x^1
+			return true;
+		else if (expr->Right()->IsInteger() && expr->Right()->bValue().FitsInt())
+			Emit(Op::POWI, r, r, (std::uint32_t)expr->Right()->bValue().ToInt());
+		else
+		{
+			if (!Compile(expr->Right(), r + 1))
+				return false;
+
+			Emit(Op::POW, r, r, r + 1);
+		}
+		return true;
+	case ExprType::LOG:
+		if (!Compile(expr->Param(), r) || !Compile(expr->Base(), r + 1))
+			return false;
+
+		Emit(Op::LOG, r, r, r + 1);
+		return true;
+	case ExprType::LN:
+	case ExprType::SIN:
+	case ExprType::COS:
+	case ExprType::TAN:
+	case ExprType::FAC:
+	{
+		Op op = Op::FAC;
+
+		if (expr->IsLn())
+			op = Op::LN;
+		else if (expr->IsSin())
+			op = Op::SIN;
+		else if (expr->IsCos())
+			op = Op::COS;
+		else if (expr->IsTan())
+			op = Op::TAN;
+
+		// Factorials and functions of numbers are computed once, here
+		if (expr->Param()->IsNumber())
+		{
+			Emit(Op::CONST, r, Constant(Unary(op, NumericValue(expr->Param()))));
+			return true;
+		}
+
+		if (!Compile(expr->Param(), r))
+			return false;
+
+		Emit(op, r, r);
+		return true;
+	}
+	default:
+		break;
+	}
+
+	return false;
+}
+
+/* Sums and products, generic or binary. The numbers among the operands are folded into one
+*  constant that is applied last, and a product with -1 becomes a negation:
+*
+*      2x(-1)y3  -->  x*y, then times -6
+*/
+bool Program::CompileOperands(const std::unique_ptr<Expr>& expr, std::uint32_t r)
+{
+	bool is_add = expr->IsAdd();
+	double constant = is_add ? 0.0 : 1.0;
+	bool has_value = false;
+	int count = expr->IsGeneric() ? expr->ChildrenSize() : 2;
+
+	for (int k = 0; k < count; k++)
+	{
+		const std::unique_ptr<Expr>& child = expr->IsGeneric() ? expr->ChildAt(k) : (k == 0 ? expr->Left() : expr->Right());
+
+		if (!child)
+			return false;
+
+		if (child->IsNumber())
+		{
+			if (is_add)
+				constant += NumericValue(child);
+			else
+				constant *= NumericValue(child);
+		}
+		else if (!has_value)
+		{
+			if (!Compile(child, r))
+				return false;
+
+			has_value = true;
+		}
+		else
+		{
+			if (!Compile(child, r + 1))
+				return false;
+
+			Emit(is_add ? Op::ADD : Op::MUL, r, r, r + 1);
+		}
+	}
+
+	if (!has_value)
+		Emit(Op::CONST, r, Constant(constant));
+	else if (!is_add && constant == -1.0)
+		Emit(Op::NEG, r, r);
+	else if (is_add ? constant != 0.0 : constant != 1.0)
+		Emit(is_add ? Op::ADDK : Op::MULK, r, r, Constant(constant));
+
+	return true;
+}
+
+double Program::Run(const double* slots, double* registers) const
+{
+	const double* constants = m_constants.data();
+	double* reg = registers;
+
+	for (const Instruction& instruction : m_code)
+	{
+		const std::uint32_t d = instruction.d;
+		const std::uint32_t a = instruction.a;
+		const std::uint32_t b = instruction.b;
+
+		switch (instruction.op)
+		{
+		case Op::CONST: reg[d] = constants[a]; break;
+		case Op::LOAD:  reg[d] = slots[a]; break;
+		case Op::ADD:   reg[d] = reg[a] + reg[b]; break;
+		case Op::MUL:   reg[d] = reg[a] * reg[b]; break;
+		case Op::ADDK:  reg[d] = reg[a] + constants[b]; break;
+		case Op::MULK:  reg[d] = reg[a] * constants[b]; break;
+		case Op::NEG:   reg[d] = -reg[a]; break;
+		case Op::POW:   reg[d] = std::pow(reg[a], reg[b]); break;
+		case Op::POWI:  reg[d] = PowInt(reg[a], (std::int32_t)b); break;
+		case Op::SIN:   reg[d] = std::sin(reg[a]); break;
+		case Op::COS:   reg[d] = std::cos(reg[a]); break;
+		case Op::TAN:   reg[d] = std::tan(reg[a]); break;
+		case Op::LN:    reg[d] = std::log(reg[a]); break;
+		case Op::LOG:   reg[d] = std::log(reg[a]) / std::log(reg[b]); break;
+		case Op::FAC:   reg[d] = std::tgamma(reg[a] + 1.0); break;
+		}
+	}
+
+	return m_code.empty() ? 0.0 : reg[0];
+}
+
+double NumericValue(const std::unique_ptr<Expr>& expr)
+{
+	if (expr->IsInteger())
+		return expr->bValue().ToDouble();
+	else if (expr->IsFraction())
+		return expr->rValue().ToDouble();
+
+	return (double)expr->fValue();
+}
+
+double PowInt(double base, std::int32_t exponent)
+{
+	std::uint32_t n = exponent < 0 ? 0u - (std::uint32_t)exponent : (std::uint32_t)exponent;
+	double result = 1.0;
+
+	while (n != 0)
+	{
+		if (n & 1)
+			result *= base;
+
+		base *= base;
+		n >>= 1;
+	}
+
+	return exponent < 0 ? 1.0 / result : result;
+}
+
+} // namespace bytecode
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "Expr.h"
+
+namespace bytecode {
+
+enum class Op : std::uint8_t
+{
+	CONST,  // r[d] = constants[a]
+	LOAD,   // r[d] = slots[a]
+	ADD,    // r[d] = r[a] + r[b]
+	MUL,    // r[d] = r[a] * r[b]
+	ADDK,   // r[d] = r[a] + constants[b]
+	MULK,   // r[d] = r[a] * constants[b]
+	NEG,    // r[d] = -r[a]
+	POW,    // r[d] = r[a] ^ r[b]
+	POWI,   // r[d] = r[a] ^ b, b a signed integer, by repeated squaring
+	SIN,
+	COS,
+	TAN,
+	LN,
+	LOG,    // r[d] = log(r[a]) / log(r[b])
+	FAC     // r[d] = gamma(r[a] + 1)
+};
+
+struct Instruction
+{
+	Op op;
+	std::uint32_t d;
+	std::uint32_t a;
+	std::uint32_t b;
+};
+
+/* An expression lowered to instructions over an array of double registers. Registers are
+*  handed out like a stack while compiling, so a program needs only as many of them as
+*  the expression is deep:
+*
+*      3x^2+sin(y)  -->  LOAD r0 x | POWI r0 r0 2 | MULK r0 r0 3 | LOAD r1 y | SIN r1 r1 | ADD r0 r0 r1
+*
+*  Variables are read from slots, one per distinct variable in the order of Variables(),
+*  so running a program with new values is just filling an array.
+*/
+class Program
+{
+private:
+	std::vector<Instruction> m_code;
+	std::vector<double> m_constants;
+	std::vector<symbol::Id> m_variables;
+	std::uint32_t m_registers{ 0 };
+
+	std::uint32_t Constant(double value);
+	std::uint32_t Slot(symbol::Id id);
+	void Emit(Op op, std::uint32_t d, std::uint32_t a, std::uint32_t b = 0);
+
+	bool Compile(const std::unique_ptr<Expr>& expr, std::uint32_t r);
+	bool CompileOperands(const std::unique_ptr<Expr>& expr, std::uint32_t r);
+
+public:
+	Program() {}
+	Program(const std::unique_ptr<Expr>& expr);
+
+	bool Empty() const { return m_code.empty(); } // Also when the expression has no numeric value, like D(x)
+	std::size_t Size() const { return m_code.size(); }
+	std::uint32_t Registers() const { return m_registers; }
+	const std::vector<symbol::Id>& Variables() const { return m_variables; }
+	const std::vector<Instruction>& Code() const { return m_code; }
+	const std::vector<double>& Constants() const { return m_constants; }
+	int SlotOf(symbol::Id id) const; // -1 when the variable doesn't occur
+
+	// registers must hold Registers() values; nothing is allocated
+	double Run(const double* slots, double* registers) const;
+};
+
+// Owns the registers of a program, for evaluating it over and over
+class Machine
+{
+private:
+	const Program& m_program;
+	std::vector<double> m_registers;
+
+public:
+	Machine(const Program& program) : m_program(program), m_registers(program.Registers()) {}
+
+	double Run(const double* slots) { return m_program.Run(slots, m_registers.data()); }
+	double Run(const std::vector<double>& slots) { return Run(slots.data()); }
+};
+
+double NumericValue(const std::unique_ptr<Expr>& expr); // Value of a number node
+double PowInt(double base, std::int32_t exponent);
+
+} // namespace bytecode
@@ -4,7 +4,7 @@ namespace calc {
 
 void Calculate(std::unique_ptr<Expr>& root)
 {
-	if (root->IsTerminal())
+	if (root->IsTerminal() || root->Settled())
 		return;
 
 	if (!root->LeftIsTerminal())
@@ -14,20 +14,24 @@ void Calculate(std::unique_ptr<Expr>& root)
 		Calculate(root->Right());
 
 	if (root->IsFunc())
-	{
 		Calculate(root->Param());
+	else if (root->IsGeneric())
+		parallel::ForEachChild(root, Calculate);
 
+	root->Rehash();
+	CalculateNode(root);
+}
+
+void CalculateNode(std::unique_ptr<Expr>& root)
+{
+	if (root->IsFunc())
+	{
 		ComputeFactorial(root);
 		ComputeLogarithm(root);
 		ComputeTrigonometric(root);
 	}
 	else if (root->IsGeneric())
-	{
-		for (int i = 0; i < root->ChildrenSize(); i++)
-			Calculate(root->ChildAt(i));
-
 		CalculateGenNode(root);
-	}
 	else
 		CalculateBinNode(root);
 }
@@ -42,7 +46,7 @@ void CalculateBinNode(std::unique_ptr<Expr>& root)
 	else if (root->IsAdd())
 		root = std::move(AddNumbers(root->Left(), root->Right()));
 	else if (root->IsPow())
-		root = std::make_unique<Float>(pow(root->Left()->fValue(), root->Right()->fValue()));
+		root = PowNumbers(root->Left(), root->Right());
 }
 
 void CalculateGenNode(std::unique_ptr<Expr>& root)
@@ -55,6 +59,20 @@ void CalculateGenNode(std::unique_ptr<Expr>& root)
 
 void UpdateChildren(std::unique_ptr<Expr>& expr, bool isMul)
 {
+	bool has_number = false;
+
+	for (int i = 0; i < expr->ChildrenSize(); i++)
+	{
+		if (expr->ChildAt(i)->IsNumber())
+		{
+			has_number = true;
+			break;
+		}
+	}
+
+	if (!has_number) // Node would be rebuilt as it is
+		return;
+
 	std::unique_ptr<Expr> previous_number = nullptr;
 	std::unique_ptr<Expr> gen_node;
 
@@ -78,11 +96,7 @@ void UpdateChildren(std::unique_ptr<Expr>& expr, bool isMul)
 			}
 		}
 		else
-		{
-			std::unique_ptr<Expr> child_copy;
-			tree_util::Clone(child_copy, expr->ChildAt(i));
-			gen_node->AddChild(std::move(child_copy));
-		}
+			gen_node->AddChild(std::move(expr->ChildAt(i)));
 	}
 
 	if (previous_number)
@@ -96,116 +110,59 @@ void UpdateChildren(std::unique_ptr<Expr>& expr, bool isMul)
 
 std::unique_ptr<Expr>& AddNumbers(std::unique_ptr<Expr>& expr_a, std::unique_ptr<Expr>& expr_b)
 {
-	std::unique_ptr<Expr> result{ std::make_unique<Integer>(0) };
-
 	if (expr_a->IsFloat() || expr_b->IsFloat())
-		result = std::make_unique<Float>(expr_a->fValue() + expr_b->fValue());
-	else if (expr_a->IsInteger())
-	{
-		if (expr_b->IsInteger())
-			result = std::make_unique<Integer>(expr_a->iValue() + expr_b->iValue());
-		else if (expr_b->IsFraction())
-			result = std::make_unique<Fraction>(expr_b->Numerator() + expr_a->iValue() * expr_b->Denominator(), expr_b->Denominator());
-	}
-	else if (expr_a->IsFraction())
-	{
-		if (expr_b->IsInteger())
-			result = std::make_unique<Fraction>(expr_a->Numerator() + expr_b->iValue() * expr_a->Denominator(), expr_a->Denominator());
-		else if (expr_b->IsFraction())
-		{
-			int numerator = expr_a->Numerator() * expr_b->Denominator() + expr_b->Numerator() * expr_a->Denominator();
-			int denominator = expr_a->Denominator() * expr_b->Denominator();
-			result = std::make_unique<Fraction>(numerator, denominator);
-		}
-	}
-
-	if (result->IsFraction())
-		ReduceFraction(result);
+		expr_a = std::make_unique<Float>(expr_a->fValue() + expr_b->fValue());
+	else
+		expr_a = ToNumber(expr_a->rValue() + expr_b->rValue());
 
-	expr_a = std::move(result);
 	return expr_a;
 }
 
 std::unique_ptr<Expr>& MulNumbers(std::unique_ptr<Expr>& expr_a, std::unique_ptr<Expr>& expr_b)
 {
-	std::unique_ptr<Expr> result{ std::make_unique<Integer>(1) };
-
 	if (expr_a->IsFloat() || expr_b->IsFloat())
-		result = std::make_unique<Float>(expr_a->fValue() * expr_b->fValue());
-	else if (expr_a->IsInteger())
-	{
-		if (expr_b->IsInteger())
-			result = std::make_unique<Integer>(expr_a->iValue() * expr_b->iValue());
-		else if (expr_b->IsFraction())
-			result = std::make_unique<Fraction>(expr_b->Numerator() * expr_a->iValue(), expr_b->Denominator());
-	}
-	else if (expr_a->IsFraction())
-	{
-		if (expr_b->IsInteger())
-			result = std::make_unique<Fraction>(expr_a->Numerator() * expr_b->iValue(), expr_a->Denominator());
-		else if (expr_b->IsFraction())
-		{
-			int numerator = expr_a->Numerator() * expr_b->Numerator();
-			int denominator = expr_a->Denominator() * expr_b->Denominator();
-			result = std::make_unique<Fraction>(numerator, denominator);
-		}
-	}
-
-	if (result->IsFraction())
-		ReduceFraction(result);
-
-	expr_a = std::move(result);
+		expr_a = std::make_unique<Float>(expr_a->fValue() * expr_b->fValue());
+	else
+		expr_a = ToNumber(expr_a->rValue() * expr_b->rValue());
 
 	return expr_a;
 }
 
-void ReduceFraction(std::unique_ptr<Expr>& expr)
+// a^n with integers stays exact as long as the result is reasonably small
+std::unique_ptr<Expr> PowNumbers(const std::unique_ptr<Expr>& base, const std::unique_ptr<Expr>& exponent)
 {
-	int smaller_fraction = 0;
-	int larger_fraction = 0;
-	int result = -1;
-
-	if (std::abs(expr->Numerator()) == 1 && expr->Denominator() > 1)
-		return;
-	else if (std::abs(expr->Numerator()) > std::abs(expr->Denominator()))
-	{
-		larger_fraction = std::abs(expr->Numerator());
-		smaller_fraction = std::abs(expr->Denominator());
-	}
-	else
+	if ((base->IsInteger() || base->IsFraction()) && exponent->IsInteger() && exponent->bValue().FitsInt())
 	{
-		larger_fraction = std::abs(expr->Denominator());
-		smaller_fraction = std::abs(expr->Numerator());
-	}
+		Rational value = base->rValue();
+		int n = exponent->iValue();
+		unsigned k = n < 0 ? 0u - (unsigned)n : (unsigned)n;
+		double bits = k * (std::log2(std::fabs(value.Numerator().ToDouble()) + 1.0) + std::log2(value.Denominator().ToDouble() + 1.0));
 
-	if (larger_fraction % smaller_fraction == 0)
-		expr = std::make_unique<Integer>(expr->Numerator() / expr->Denominator());
-	else
-	{
-		while (true)
+		// A negative exponent flips the fraction, which 0 can't do
+		if (bits <= max_exact_power_bits && (n >= 0 || value.Sign() != 0))
 		{
-			result = larger_fraction - smaller_fraction;
+			if (n >= 0)
+				return ToNumber(Rational(value.Numerator().Pow(k), value.Denominator().Pow(k)));
 
-			if (result == 0)
-			{
-				result = smaller_fraction;
-				break;
-			}
-
-			if (result > smaller_fraction)
-				larger_fraction = result;
-			else
-			{
-				larger_fraction = smaller_fraction;
-				smaller_fraction = result;
-			}
+			return ToNumber(Rational(value.Denominator().Pow(k), value.Numerator().Pow(k)));
 		}
+	}
 
-		int numerator = expr->Numerator() / result;
-		int denominator = expr->Denominator() / result;
+	return std::make_unique<Float>(pow(base->fValue(), exponent->fValue()));
+}
 
-		expr = std::make_unique<Fraction>(numerator, denominator);
-	}
+// Rationals are always in lowest terms, so only whole numbers need to become integers
+std::unique_ptr<Expr> ToNumber(const Rational& value)
+{
+	if (value.IsInteger())
+		return std::make_unique<Integer>(value.Numerator());
+
+	return std::make_unique<Fraction>(value);
+}
+
+void ReduceFraction(std::unique_ptr<Expr>& expr)
+{
+	expr = ToNumber(expr->rValue());
 }
 
 void ComputeFactorial(std::unique_ptr<Expr>& expr)
@@ -213,21 +170,21 @@ void ComputeFactorial(std::unique_ptr<Expr>& expr)
 	if (!expr->IsFac())
 		return;
 
-	if (expr->Param()->IsInteger())
+	if (expr->Param()->IsInteger() && expr->Param()->bValue().FitsInt())
 	{
-		int result = 1;
 		int lim = expr->Param()->iValue();
+		double n = std::abs((double)lim);
 
-		if (lim < 0)
-		{
-			result = -1;
-			lim = abs(lim);
-		}
+		// n! has fewer than n*log2(n) bits, larger factorials are left unevaluated
+		if (n > 1 && n * std::log2(n) > max_exact_factorial_bits)
+			return;
 
-		for (int i = 1; i <= lim; i++)
-			result *= i;
+		BigInt result = Factorial(std::abs(lim));
 
-		expr = std::make_unique<Integer>(result);
+		if (lim < 0)
+			result = -result;
+
+		expr = std::make_unique<Integer>(std::move(result));
 	}
 }
 
@@ -298,17 +255,30 @@ void ComputeTrigonometric(std::unique_ptr<Expr>& expr)
 	}
 }
 
-int Factorial(int number)
+// Product of from..to, split in halves so that large factors are multiplied with each other
+BigInt ProductRange(int from, int to)
 {
-	if (number == 0 || number == 1)
+	if (from > to)
 		return 1;
 
-	int result = 1;
+	if (to - from < 8)
+	{
+		BigInt result = from;
 
-	for (int i = 1; i <= number; i++)
-		result *= i;
+		for (int i = from + 1; i <= to; i++)
+			result *= i;
+
+		return result;
+	}
 
-	return result;
+	int middle = from + (to - from) / 2;
+
+	return ProductRange(from, middle) * ProductRange(middle + 1, to);
+}
+
+BigInt Factorial(int number)
+{
+	return ProductRange(2, number);
 }
 
 } //namespace calc
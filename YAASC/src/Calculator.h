@@ -5,22 +5,30 @@
 
 #include "Expr.h"
 #include "TreeUtil.h"
+#include "Parallel.h"
 
 namespace calc {
 
+constexpr double max_exact_power_bits = 65536;
+constexpr double max_exact_factorial_bits = 1 << 21;
+
 void Calculate(std::unique_ptr<Expr>& expr);
+void CalculateNode(std::unique_ptr<Expr>& expr);
 void CalculateBinNode(std::unique_ptr<Expr>& expr);
 void CalculateGenNode(std::unique_ptr<Expr>& expr);
 void UpdateChildren(std::unique_ptr<Expr>& root, bool isMul);
 
 std::unique_ptr<Expr>& AddNumbers(std::unique_ptr<Expr>& expr_a, std::unique_ptr<Expr>& expr_b);
 std::unique_ptr<Expr>& MulNumbers(std::unique_ptr<Expr>& expr_a, std::unique_ptr<Expr>& expr_b);
+std::unique_ptr<Expr> PowNumbers(const std::unique_ptr<Expr>& base, const std::unique_ptr<Expr>& exponent);
+std::unique_ptr<Expr> ToNumber(const Rational& value);
 
 void ReduceFraction(std::unique_ptr<Expr>& expr);
 void ComputeFactorial(std::unique_ptr<Expr>& expr);
 void ComputeLogarithm(std::unique_ptr<Expr>& expr);
 void ComputeTrigonometric(std::unique_ptr<Expr>& expr);
 
-int Factorial(int number);
+BigInt ProductRange(int from, int to);
+BigInt Factorial(int number);
 
 } // namespace calc
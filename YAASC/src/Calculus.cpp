@@ -4,16 +4,13 @@ namespace calculus {
 
 void Differentiate(std::unique_ptr<Expr>& expr)
 {
-	if (expr->IsTerminal())
+	if (expr->IsTerminal() || expr->Settled())
 		return;
 
 	if (expr->IsFunc())
 		Differentiate(expr->Param());
 	else if (expr->IsGeneric())
-	{
-		for (int i = 0; i < expr->ChildrenSize(); i++)
-			Differentiate(expr->ChildAt(i));
-	}
+		parallel::ForEachChild(expr, Differentiate);
 	else
 	{
 		if (!expr->LeftIsTerminal())
@@ -23,6 +20,7 @@ void Differentiate(std::unique_ptr<Expr>& expr)
 			Differentiate(expr->Right());
 	}
 
+	expr->Rehash();
 	ApplyDerivativeRules(expr);
 }
 
@@ -42,18 +40,18 @@ void PowerRule(std::unique_ptr<Expr>& expr)
 		return;
 	}
 
-	if (!expr->Param()->Left()->IsPow())
-		return;
+	// Variables are read in as x^1, so the base is x^1 unless the exponents have already been merged
+	std::unique_ptr<Expr>& base = expr->Param()->Left()->IsPow() ? expr->Param()->Left()->Left() : expr->Param()->Left();
 
-	if (!expr->Param()->Left()->Left()->IsVar())
+	if (!base->IsVar())
 		return;
 
-	if (expr->Param()->Left()->Left()->Name() != expr->RespectTo())
+	if (base->Symbol() != expr->RespectTo())
 		return;
 
 	std::unique_ptr<Expr> multiplier;
 	tree_util::Clone(multiplier, expr->Param()->Right());
-	std::unique_ptr<Expr> var = std::move(expr->Param()->Left()->Left());
+	std::unique_ptr<Expr> var = std::move(base);
 	std::unique_ptr<Expr> new_expr = std::make_unique<Mul>(std::move(multiplier), std::make_unique<Pow>(std::move(var),
 	                                 std::make_unique<Add>(std::move(expr->Param()->Right()), std::make_unique<Integer>(-1))));
 
@@ -90,7 +88,7 @@ void SetToOne(std::unique_ptr<Expr>& expr)
 	(void)expr;
 }
 
-void CanDifferentiate(const std::unique_ptr<Expr>& expr, std::string respect_to, bool& is_constant)
+void CanDifferentiate(const std::unique_ptr<Expr>& expr, symbol::Id respect_to, bool& is_constant)
 {
 	if (!is_constant)
 		return;
@@ -110,7 +108,7 @@ void CanDifferentiate(const std::unique_ptr<Expr>& expr, std::string respect_to,
 			CanDifferentiate(expr->Right(), respect_to, is_constant);
 	}
 
-	if (respect_to == expr->Name())
+	if (respect_to == expr->Symbol())
 		is_constant = false;
 }
 
@@ -137,6 +135,8 @@ void DifferentiateSum(std::unique_ptr<Expr>& expr)
 
 		for (int i = 0; i < expr->ChildrenSize(); i++)
 			ApplyDerivativeRules(expr->ChildAt(i));
+
+		expr->Rehash();
 	}
 	else
 	{
@@ -146,6 +146,7 @@ void DifferentiateSum(std::unique_ptr<Expr>& expr)
 
 		ApplyDerivativeRules(expr->Left());
 		ApplyDerivativeRules(expr->Right());
+		expr->Rehash();
 	}
 }
 
@@ -184,6 +185,8 @@ void ProductRule(std::unique_ptr<Expr>& expr)
 			for (int k = 0; k < mul_node->ChildrenSize(); k++)
 				ApplyDerivativeRules(mul_node->ChildAt(k));
 
+			mul_node->Rehash();
+
 			add_node->AddChild(std::move(mul_node));
 		}
 		
@@ -200,6 +203,8 @@ void ProductRule(std::unique_ptr<Expr>& expr)
 
 		ApplyDerivativeRules(left->Left());
 		ApplyDerivativeRules(right->Left());
+		left->Rehash();
+		right->Rehash();
 
 		expr = std::make_unique<Add>(std::move(left), std::move(right));
 	}
@@ -229,11 +234,15 @@ void QuotientRule(std::unique_ptr<Expr>& expr)
 	tree_util::Clone(copy_right_a, expr->Param()->Right()->Left());
 	tree_util::Clone(copy_right_b, expr->Param()->Right()->Left());
 
-	std::unique_ptr<Expr> left = std::make_unique<Mul>(std::make_unique<Derivative>(std::move(expr->Param()->Left()), "x"), std::move(copy_right_a));
+	// a2 is raised to one, since it is bare when (a2^1)^-1 has already become a2^-1, and a2^1 merges with a2^-2
+	std::unique_ptr<Expr> left = std::make_unique<Mul>(std::make_unique<Derivative>(std::move(expr->Param()->Left()), "x"),
+	                             std::make_unique<Pow>(std::move(copy_right_a), std::make_unique<Integer>(1)));
 	std::unique_ptr<Expr> right = std::make_unique<Mul>(std::make_unique<Derivative>(std::move(expr->Param()->Right()->Left()), "x"), std::move(copy_left));
 
 	ApplyDerivativeRules(left->Left());
 	ApplyDerivativeRules(right->Left());
+	left->Rehash();
+	right->Rehash();
 
 	numerator = std::make_unique<Add>(std::move(left), std::make_unique<Mul>(std::make_unique<Integer>(-1), std::move(right)));
 	denominator = std::make_unique<Pow>(std::move(copy_right_b), std::make_unique<Integer>(-2));
@@ -306,7 +315,10 @@ void ApplyDerivativeRules(std::unique_ptr<Expr>& expr, bool skip_chain_rule)
 	if (expr->IsZero())
 		return;
 
-	if (!skip_chain_rule && CanApplyChainRule(expr->Param()))
+	// d/dx(x) --> 1, the exponent of x^1 is gone once a power of it has been merged: (x^1)^n --> x^n
+	if (expr->Param()->IsVar())
+		expr = std::make_unique<Integer>(1);
+	else if (!skip_chain_rule && CanApplyChainRule(expr->Param()))
 		ChainRule(expr);
 	else if (expr->Param()->IsAdd())
 		DifferentiateSum(expr);
@@ -329,20 +341,30 @@ void ApplyDerivativeRules(std::unique_ptr<Expr>& expr, bool skip_chain_rule)
 	}
 	else if (expr->Param()->IsFunc())
 	{
-		if (expr->Param()->IsSin())
+		switch (expr->Param()->ExpressionType())
+		{
+		case ExprType::SIN:
 			expr = std::make_unique<Cos>(std::move(expr->Param()->Param()));
-		else if (expr->Param()->IsCos())
+			break;
+		case ExprType::COS:
 			expr = std::make_unique<Mul>(std::make_unique<Integer>(-1), std::make_unique<Sin>(std::move(expr->Param()->Param())));
-		else if (expr->Param()->IsTan())
+			break;
+		case ExprType::TAN:
 			expr = std::make_unique<Pow>(std::make_unique<Cos>(std::move(expr->Param()->Param())), std::make_unique<Integer>(-2));
-		else if (expr->Param()->IsLn())
+			break;
+		case ExprType::LN:
 			expr = std::make_unique<Pow>(std::move(expr->Param()->Param()), std::make_unique<Integer>(-1));
-		else if (expr->Param()->IsLog())
+			break;
+		case ExprType::LOG:
 			expr = std::make_unique<Pow>(std::make_unique<Mul>(std::move(expr->Param()->Param()), std::make_unique<Ln>(std::move(expr->Param()->Base()))), std::make_unique<Integer>(-1));
+			break;
+		default:
+			break;
+		}
 	}
 }
 
-bool IsConstant(const std::unique_ptr<Expr>& expr, std::string respect_to)
+bool IsConstant(const std::unique_ptr<Expr>& expr, symbol::Id respect_to)
 {
 	bool is_constant = true;
 	CanDifferentiate(expr, respect_to, is_constant);
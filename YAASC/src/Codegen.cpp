@@ -0,0 +1,331 @@
+#include <cmath>
+#include <cstdio>
+#include <climits>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <filesystem>
+
+#if !defined _WIN32
+	#include <dlfcn.h>
+	#include <unistd.h>
+#endif
+
+#include "Codegen.h"
+#include "Bytecode.h"
+#include "Printer.h"
+
+namespace codegen {
+
+std::string Literal(double value)
+{
+	if (std::isnan(value))
+		return "NAN";
+	else if (std::isinf(value))
+		return value < 0 ? "-HUGE_VAL" : "HUGE_VAL";
+
+	char digits[32];
+	std::snprintf(digits, sizeof(digits), "%.17g", value);
+	std::string literal = digits;
+
+	// Keeps integer constants out of integer arithmetic in C
+	if (literal.find_first_of(".e") == std::string::npos)
+		literal += ".0";
+
+	return value < 0 ? "(" + literal + ")" : literal;
+}
+
+std::string Generator::Temporary(const std::string& value)
+{
+	std::string name = "t" + std::to_string(m_temporaries++);
+	m_body << "\tconst double " << name << " = " << value << ";\n";
+
+	return name;
+}
+
+std::string Generator::Variable(symbol::Id id)
+{
+	std::size_t slot = 0;
+
+	while (slot < m_variables.size() && m_variables[slot] != id)
+		slot++;
+
+	if (slot == m_variables.size())
+		m_variables.push_back(id);
+
+	return "x[" + std::to_string(slot) + "]";
+}
+
+// Sum or product, with the numbers among the operands folded into one constant
+std::string Generator::Operands(const std::unique_ptr<Expr>& expr)
+{
+	bool is_add = expr->IsAdd();
+	double constant = is_add ? 0.0 : 1.0;
+	std::string value = "";
+	int count = expr->IsGeneric() ? expr->ChildrenSize() : 2;
+
+	for (int k = 0; k < count; k++)
+	{
+		const std::unique_ptr<Expr>& child = expr->IsGeneric() ? expr->ChildAt(k) : (k == 0 ? expr->Left() : expr->Right());
+
+		if (child->IsNumber())
+		{
+			if (is_add)
+				constant += bytecode::NumericValue(child);
+			else
+				constant *= bytecode::NumericValue(child);
+		}
+		else
+		{
+			std::string operand = Value(child);
+
+			if (value != "")
+				value += is_add ? " + " : " * ";
+
+			value += operand;
+		}
+	}
+
+	if (value == "")
+		return Literal(constant);
+	else if (!is_add && constant == -1.0)
+		return "-(" + value + ")";
+	else if (is_add ? constant != 0.0 : constant != 1.0)
+		return value + (is_add ? " + " : " * ") + Literal(constant);
+
+	return value;
+}
+
+// Square and multiply, remembering every power of the base computed on the way
+std::string Generator::Power(const std::string& base, int exponent)
+{
+	if (exponent == 0)
+		return "1.0";
+	else if (exponent < 0)
+		return Temporary("1.0 / " + Power(base, -exponent));
+	else if (exponent == 1)
+		return base;
+
+	auto found = m_powers.find({ base, exponent });
+
+	if (found != m_powers.end())
+		return found->second;
+
+	std::string half = Power(base, exponent / 2);
+	std::string result = Temporary(half + " * " + half);
+
+	if (exponent % 2 == 1)
+	{
+		m_powers[{ base, exponent - 1 }] = result;
+		result = Temporary(result + " * " + base);
+	}
+
+	return m_powers[{ base, exponent }] = result;
+}
+
+std::string Generator::Value(const std::unique_ptr<Expr>& expr)
+{
+	if (m_failed || !expr)
+	{
+		m_failed = true;
+		return "0.0";
+	}
+
+	switch (expr->ExpressionType())
+	{
+	case ExprType::INTEGER:
+	case ExprType::FLOAT:
+	case ExprType::FRACTION:
+		return Literal(bytecode::NumericValue(expr));
+	case ExprType::VARIABLE:
+		return Variable(expr->Symbol());
+	case ExprType::PI:
+		return Literal(3.14159265358979323846);
+	case ExprType::e:
+		return Literal(2.71828182845904523536);
+	default:
+		break;
+	}
+
+	std::vector<std::pair<const std::unique_ptr<Expr>*, std::string>>& same_hash = m_subterms[expr->Hash()];
+
+	for (const auto& [subterm, name] : same_hash)
+	{
+		if (*subterm == expr)
+			return name;
+	}
+
+	std::string value;
+
+	switch (expr->ExpressionType())
+	{
+	case ExprType::ADD:
+	case ExprType::MUL:
+		value = Operands(expr);
+		break;
+	case ExprType::POW:
+	{
+		const std::unique_ptr<Expr>& exponent = expr->Right();
+		std::string base = Value(expr->Left());
+
+		if (exponent->IsInteger() && exponent->bValue().FitsInt() && exponent->bValue().ToInt() != INT_MIN)
+			value = Power(base, exponent->bValue().ToInt());
+		else if (exponent->IsFraction() && exponent->rValue() == Rational(1, 2))
+			value = "sqrt(" + base + ")";
+		else
+			value = "pow(" + base + ", " + Value(exponent) + ")";
+		break;
+	}
+	case ExprType::LOG:
+	{
+		std::string param = Value(expr->Param());
+
+		if (expr->Base()->IsInteger() && expr->Base()->bValue() == 10)
+			value = "log10(" + param + ")";
+		else if (expr->Base()->IsInteger() && expr->Base()->bValue() == 2)
+			value = "log2(" + param + ")";
+		else
+			value = "log(" + param + ") / log(" + Value(expr->Base()) + ")";
+		break;
+	}
+	case ExprType::LN:
+		value = "log(" + Value(expr->Param()) + ")";
+		break;
+	case ExprType::SIN:
+		value = "sin(" + Value(expr->Param()) + ")";
+		break;
+	case ExprType::COS:
+		value = "cos(" + Value(expr->Param()) + ")";
+		break;
+	case ExprType::TAN:
+		value = "tan(" + Value(expr->Param()) + ")";
+		break;
+	case ExprType::FAC:
+		if (expr->Param()->IsNumber())
+			value = Literal(std::tgamma(bytecode::NumericValue(expr->Param()) + 1.0));
+		else
+			value = "tgamma(" + Value(expr->Param()) + " + 1.0)";
+		break;
+	default:
+		m_failed = true;
+		return "0.0";
+	}
+
+	// Temporaries and variables are already values, everything else gets one
+	std::string name = value;
+
+	if (value.find_first_of(" (") != std::string::npos || value[0] == '-')
+		name = Temporary(value);
+
+	// The vector may have grown while the operands were generated
+	m_subterms[expr->Hash()].push_back({ &expr, name });
+
+	return name;
+}
+
+Source Generator::Generate(const std::unique_ptr<Expr>& expr, const std::string& function_name)
+{
+	Source source;
+	std::string result = Value(expr);
+
+	if (m_failed)
+		return source;
+
+	std::ostringstream code;
+	code << "/* " << printer::ToString(expr) << " */\n";
+	code << "#include <math.h>\n\n";
+	code << "double " << function_name << "(const double* x)\n{\n";
+	code << m_body.str();
+	code << "\treturn " << result << ";\n}\n";
+
+	source.code = code.str();
+	source.function_name = function_name;
+	source.variables = m_variables;
+	source.temporaries = m_temporaries;
+
+	return source;
+}
+
+Source Generate(const std::unique_ptr<Expr>& expr, const std::string& function_name)
+{
+	Generator generator;
+	return generator.Generate(expr, function_name);
+}
+
+bool Library::Compile(const std::unique_ptr<Expr>& expr, const std::string& compiler)
+{
+	return Compile(Generate(expr), compiler);
+}
+
+bool Library::Compile(const Source& source, const std::string& compiler)
+{
+	Close();
+
+	if (source.code == "")
+		return false;
+
+#if defined _WIN32
+	(void)compiler;
+	return false;
+#else
+	static std::atomic<int> counter{ 0 };
+
+	std::error_code error;
+	std::filesystem::path directory = std::filesystem::temp_directory_path(error);
+
+	if (error)
+		return false;
+
+	std::string stem = "yaasc_" + std::to_string(getpid()) + "_" + std::to_string(counter++);
+	std::string c_path = (directory / (stem + ".c")).string();
+	std::string library_path = (directory / (stem + ".so")).string();
+
+	{
+		std::ofstream file(c_path);
+
+		if (!file.is_open())
+			return false;
+
+		file << source.code;
+	}
+
+	std::string command = compiler + " -O2 -shared -fPIC -o '" + library_path + "' '" + c_path + "' -lm 2>/dev/null";
+	bool compiled = std::system(command.c_str()) == 0;
+
+	if (compiled)
+		m_handle = dlopen(library_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+
+	// The loaded library stays mapped after its file is removed
+	std::filesystem::remove(c_path, error);
+	std::filesystem::remove(library_path, error);
+
+	if (m_handle == nullptr)
+		return false;
+
+	m_function = reinterpret_cast<Function>(dlsym(m_handle, source.function_name.c_str()));
+
+	if (m_function == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	m_variables = source.variables;
+
+	return true;
+#endif
+}
+
+void Library::Close()
+{
+#if !defined _WIN32
+	if (m_handle != nullptr)
+		dlclose(m_handle);
+#endif
+
+	m_handle = nullptr;
+	m_function = nullptr;
+	m_variables.clear();
+}
+
+} // namespace codegen
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <unordered_map>
+
+#include "Expr.h"
+
+namespace codegen {
+
+struct Source
+{
+	std::string code;                    // Empty when the expression has no numeric value, like D(x)
+	std::string function_name;
+	std::vector<symbol::Id> variables;   // Variable k is read from x[k]
+	int temporaries{ 0 };
+};
+
+/* Writes an expression as a C function of an array of doubles. Every subterm is computed
+*  once into a temporary, and a subterm that occurs again, found by its hash, reuses it.
+*  Integer powers become chains of squarings that are shared as well:
+*
+*      sin(x^2)+x^4cos(x^2)  -->  t0 = x[0] * x[0]
+*                                 t1 = sin(t0)
+*                                 t2 = t0 * t0
+*                                 t3 = cos(t0)
+*                                 t4 = t2 * t3
+*                                 t5 = t1 + t4
+*/
+class Generator
+{
+private:
+	std::ostringstream m_body;
+	std::vector<symbol::Id> m_variables;
+	int m_temporaries{ 0 };
+	bool m_failed{ false };
+
+	std::unordered_map<std::size_t, std::vector<std::pair<const std::unique_ptr<Expr>*, std::string>>> m_subterms;
+	std::map<std::pair<std::string, int>, std::string> m_powers;
+
+	std::string Temporary(const std::string& value);
+	std::string Variable(symbol::Id id);
+	std::string Operands(const std::unique_ptr<Expr>& expr);
+	std::string Power(const std::string& base, int exponent);
+	std::string Value(const std::unique_ptr<Expr>& expr);
+
+public:
+	Source Generate(const std::unique_ptr<Expr>& expr, const std::string& function_name);
+};
+
+Source Generate(const std::unique_ptr<Expr>& expr, const std::string& function_name = "yaasc_eval");
+
+std::string Literal(double value);
+
+using Function = double (*)(const double*);
+
+/* Compiles generated code into a shared library with the system compiler and loads it
+*  with dlopen. Only where dlopen exists; elsewhere Compile() returns false.
+*/
+class Library
+{
+private:
+	void* m_handle{ nullptr };
+	Function m_function{ nullptr };
+	std::vector<symbol::Id> m_variables;
+
+public:
+	Library() {}
+	~Library() { Close(); }
+
+	Library(const Library&) = delete;
+	Library& operator=(const Library&) = delete;
+
+	bool Compile(const std::unique_ptr<Expr>& expr, const std::string& compiler = "cc");
+	bool Compile(const Source& source, const std::string& compiler = "cc");
+	void Close();
+
+	bool IsLoaded() const { return m_function != nullptr; }
+	const std::vector<symbol::Id>& Variables() const { return m_variables; }
+	Function Get() const { return m_function; }
+
+	double Run(const double* slots) const { return m_function(slots); }
+	double Run(const std::vector<double>& slots) const { return m_function(slots.data()); }
+};
+
+} // namespace codegen
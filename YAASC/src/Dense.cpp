@@ -0,0 +1,345 @@
+#include <cmath>
+#include <algorithm>
+
+#include "Dense.h"
+
+namespace poly {
+
+struct Prime
+{
+	std::uint32_t modulus;   // c*2^k+1
+	std::uint32_t root;      // Generates the multiplicative group
+	int two_adicity;         // k, the longest transform is 2^k
+};
+
+static const Prime primes[] = {
+	{ 2013265921u, 31, 27 },
+	{ 1811939329u, 13, 26 },
+	{ 469762049u, 3, 26 },
+	{ 2113929217u, 5, 25 },
+	{ 1711276033u, 29, 25 },
+	{ 167772161u, 3, 25 },
+	{ 2130706433u, 3, 24 },
+	{ 754974721u, 11, 24 },
+	{ 998244353u, 3, 23 }
+};
+
+static void Trim(Dense& a)
+{
+	while (!a.empty() && a.back().IsZero())
+		a.pop_back();
+}
+
+// sum[shift + k] += x[k]
+static void AddShifted(Dense& sum, const Dense& x, std::size_t shift)
+{
+	if (sum.size() < shift + x.size())
+		sum.resize(shift + x.size());
+
+	for (std::size_t k = 0; k < x.size(); k++)
+		sum[shift + k] += x[k];
+}
+
+static Dense Sum(const Dense& a, const Dense& b)
+{
+	Dense sum = a;
+	AddShifted(sum, b, 0);
+
+	return sum;
+}
+
+static void Subtract(Dense& a, const Dense& b)
+{
+	if (a.size() < b.size())
+		a.resize(b.size());
+
+	for (std::size_t k = 0; k < b.size(); k++)
+		a[k] -= b[k];
+}
+
+Dense MulSchoolbook(const Dense& a, const Dense& b)
+{
+	if (a.empty() || b.empty())
+		return Dense();
+
+	Dense product(a.size() + b.size() - 1);
+
+	for (std::size_t i = 0; i < a.size(); i++)
+	{
+		if (a[i].IsZero())
+			continue;
+
+		for (std::size_t j = 0; j < b.size(); j++)
+			product[i + j] += a[i] * b[j];
+	}
+
+	Trim(product);
+
+	return product;
+}
+
+// (a0 + a1x^h)(b0 + b1x^h) = a0b0 + ((a0 + a1)(b0 + b1) - a0b0 - a1b1)x^h + a1b1x^2h
+Dense MulKaratsuba(const Dense& a, const Dense& b)
+{
+	if (std::min(a.size(), b.size()) < dense_karatsuba_threshold)
+		return MulSchoolbook(a, b);
+
+	std::size_t half = std::max(a.size(), b.size()) / 2;
+	std::size_t a_split = std::min(half, a.size());
+	std::size_t b_split = std::min(half, b.size());
+
+	Dense a0(a.begin(), a.begin() + a_split);
+	Dense a1(a.begin() + a_split, a.end());
+	Dense b0(b.begin(), b.begin() + b_split);
+	Dense b1(b.begin() + b_split, b.end());
+
+	Dense low = MulKaratsuba(a0, b0);
+	Dense high = MulKaratsuba(a1, b1);
+	Dense middle = MulKaratsuba(Sum(a0, a1), Sum(b0, b1));
+	Subtract(middle, low);
+	Subtract(middle, high);
+
+	Dense product;
+	AddShifted(product, low, 0);
+	AddShifted(product, middle, half);
+	AddShifted(product, high, 2 * half);
+	Trim(product);
+
+	return product;
+}
+
+static std::uint32_t PowMod(std::uint64_t base, std::uint64_t exponent, std::uint32_t modulus)
+{
+	std::uint64_t result = 1;
+	base %= modulus;
+
+	for (; exponent > 0; exponent >>= 1)
+	{
+		if (exponent & 1)
+			result = result * base % modulus;
+
+		base = base * base % modulus;
+	}
+
+	return (std::uint32_t)result;
+}
+
+static std::uint32_t Residue(const BigInt& value, std::uint32_t modulus)
+{
+	std::uint64_t residue = 0;
+
+	if (value.IsSmall())
+	{
+		std::uint64_t magnitude = value.Small() < 0 ? 0 - (std::uint64_t)value.Small() : (std::uint64_t)value.Small();
+		residue = magnitude % modulus;
+	}
+	else
+	{
+		BigInt::Limbs magnitude = value.Magnitude();
+
+		for (std::size_t k = magnitude.size(); k-- > 0;)
+			residue = ((residue << 32) | magnitude[k]) % modulus;
+	}
+
+	return value.Sign() < 0 && residue != 0 ? (std::uint32_t)(modulus - residue) : (std::uint32_t)residue;
+}
+
+static int Bits(const BigInt& value)
+{
+	std::uint64_t top;
+	int bits = 0;
+
+	if (value.IsSmall())
+		top = value.Small() < 0 ? 0 - (std::uint64_t)value.Small() : (std::uint64_t)value.Small();
+	else
+	{
+		BigInt::Limbs magnitude = value.Magnitude();
+		top = magnitude.back();
+		bits = 32 * ((int)magnitude.size() - 1);
+	}
+
+	for (; top != 0; top >>= 1)
+		bits++;
+
+	return bits;
+}
+
+// In place, the length a power of two that divides p - 1
+static void Transform(std::vector<std::uint32_t>& a, const Prime& prime, bool inverse)
+{
+	std::uint32_t p = prime.modulus;
+	std::size_t n = a.size();
+
+	for (std::size_t i = 1, j = 0; i < n; i++)
+	{
+		std::size_t bit = n >> 1;
+
+		for (; j & bit; bit >>= 1)
+			j ^= bit;
+
+		j ^= bit;
+
+		if (i < j)
+			std::swap(a[i], a[j]);
+	}
+
+	std::vector<std::uint32_t> twiddles(n / 2);
+
+	for (std::size_t length = 2; length <= n; length <<= 1)
+	{
+		std::uint32_t step = PowMod(prime.root, (p - 1) / length, p);
+
+		if (inverse)
+			step = PowMod(step, p - 2, p);
+
+		twiddles[0] = 1;
+
+		for (std::size_t k = 1; k < length / 2; k++)
+			twiddles[k] = (std::uint32_t)((std::uint64_t)twiddles[k - 1] * step % p);
+
+		for (std::size_t start = 0; start < n; start += length)
+		{
+			for (std::size_t k = 0; k < length / 2; k++)
+			{
+				std::uint32_t u = a[start + k];
+				std::uint32_t v = (std::uint32_t)((std::uint64_t)a[start + k + length / 2] * twiddles[k] % p);
+
+				a[start + k] = u + v >= p ? u + v - p : u + v;
+				a[start + k + length / 2] = u >= v ? u - v : u + p - v;
+			}
+		}
+	}
+
+	if (inverse)
+	{
+		std::uint64_t scale = PowMod(n, p - 2, p);
+
+		for (std::uint32_t& value : a)
+			value = (std::uint32_t)(value * scale % p);
+	}
+}
+
+bool MulNtt(const Dense& a, const Dense& b, Dense& product)
+{
+	product.clear();
+
+	if (a.empty() || b.empty())
+		return true;
+
+	std::size_t length = a.size() + b.size() - 1;
+	std::size_t n = 1;
+	int log_n = 0;
+
+	for (; n < length; n <<= 1)
+		log_n++;
+
+	// The primes have to multiply to more than twice the largest coefficient, for the sign
+	int a_bits = 0;
+	int b_bits = 0;
+
+	for (const BigInt& coefficient : a)
+		a_bits = std::max(a_bits, Bits(coefficient));
+
+	for (const BigInt& coefficient : b)
+		b_bits = std::max(b_bits, Bits(coefficient));
+
+	double needed = a_bits + b_bits + Bits(BigInt((long long)std::min(a.size(), b.size()))) + 2;
+	double covered = 0;
+	std::vector<Prime> used;
+
+	for (const Prime& prime : primes)
+	{
+		if (covered > needed)
+			break;
+
+		if (prime.two_adicity < log_n)
+			continue;
+
+		used.push_back(prime);
+		covered += std::log2((double)prime.modulus);
+	}
+
+	if (covered <= needed)
+		return false;
+
+	std::vector<std::vector<std::uint32_t>> residues(used.size());
+
+	for (std::size_t i = 0; i < used.size(); i++)
+	{
+		std::uint32_t p = used[i].modulus;
+		std::vector<std::uint32_t> x(n, 0);
+		std::vector<std::uint32_t> y(n, 0);
+
+		for (std::size_t k = 0; k < a.size(); k++)
+			x[k] = Residue(a[k], p);
+
+		for (std::size_t k = 0; k < b.size(); k++)
+			y[k] = Residue(b[k], p);
+
+		Transform(x, used[i], false);
+		Transform(y, used[i], false);
+
+		for (std::size_t k = 0; k < n; k++)
+			x[k] = (std::uint32_t)((std::uint64_t)x[k] * y[k] % p);
+
+		Transform(x, used[i], true);
+		x.resize(length);
+		residues[i] = std::move(x);
+	}
+
+	// Garner: the value is t0 + t1p0 + t2p0p1 + ..., with every t_i below p_i
+	std::vector<std::vector<std::uint32_t>> inverses(used.size(), std::vector<std::uint32_t>(used.size()));
+	BigInt modulus = 1;
+
+	for (std::size_t i = 0; i < used.size(); i++)
+	{
+		for (std::size_t j = 0; j < i; j++)
+			inverses[j][i] = PowMod(used[j].modulus, used[i].modulus - 2, used[i].modulus);
+
+		modulus *= BigInt((long long)used[i].modulus);
+	}
+
+	BigInt half = modulus / 2;
+	std::vector<std::uint32_t> digits(used.size());
+	product.resize(length);
+
+	for (std::size_t k = 0; k < length; k++)
+	{
+		for (std::size_t i = 0; i < used.size(); i++)
+		{
+			std::uint32_t p = used[i].modulus;
+			std::uint64_t digit = residues[i][k];
+
+			for (std::size_t j = 0; j < i; j++)
+				digit = (digit + p - digits[j] % p) % p * inverses[j][i] % p;
+
+			digits[i] = (std::uint32_t)digit;
+		}
+
+		BigInt value = (long long)digits.back();
+
+		for (std::size_t i = used.size() - 1; i-- > 0;)
+			value = value * BigInt((long long)used[i].modulus) + BigInt((long long)digits[i]);
+
+		product[k] = value > half ? value - modulus : value;
+	}
+
+	Trim(product);
+
+	return true;
+}
+
+Dense Multiply(const Dense& a, const Dense& b)
+{
+	std::size_t shorter = std::min(a.size(), b.size());
+	Dense product;
+
+	if (shorter >= dense_ntt_threshold && MulNtt(a, b, product))
+		return product;
+	else if (shorter < dense_karatsuba_threshold)
+		return MulSchoolbook(a, b);
+
+	return MulKaratsuba(a, b);
+}
+
+} // namespace poly
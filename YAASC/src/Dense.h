@@ -0,0 +1,31 @@
+#pragma once
+
+#include <vector>
+
+#include "BigInt.h"
+
+namespace poly {
+
+using Dense = std::vector<BigInt>; // Coefficient of x^k at index k, without zeros at the end
+
+// Lengths where the faster products take over, measured with bench/DenseBench.cpp
+constexpr std::size_t dense_karatsuba_threshold = 32;
+constexpr std::size_t dense_ntt_threshold = 24;
+
+/* Products of univariate polynomials with integer coefficients. The number-theoretic
+*  transform multiplies the coefficients modulo a few primes p = c*2^k+1 below 2^31,
+*  as many as the largest coefficient of the product needs, and puts every coefficient
+*  back together from its residues with the Chinese remainder theorem:
+*
+*      a*b mod 998244353, a*b mod 167772161, ...  -->  a*b
+*
+*  Products whose coefficients would need more primes than there are, several hundred
+*  bits, are left to Karatsuba.
+*/
+Dense MulSchoolbook(const Dense& a, const Dense& b);
+Dense MulKaratsuba(const Dense& a, const Dense& b);
+bool MulNtt(const Dense& a, const Dense& b, Dense& product); // False when there aren't enough primes
+
+Dense Multiply(const Dense& a, const Dense& b); // Picks one of the above by length
+
+} // namespace poly
@@ -5,7 +5,7 @@ namespace algebra {
 // Multiplication of a sum: a(b+c+d) --> ab+ac+ad
 void Expand(std::unique_ptr<Expr>& root)
 {
-	if (root->IsTerminal())
+	if (root->IsTerminal() || root->Settled())
 		return;
 
 	if (root->IsGeneric())
@@ -22,9 +22,19 @@ void Expand(std::unique_ptr<Expr>& root)
 			Expand(root->Right());
 	}
 
+	root->Rehash();
+	ExpandNode(root);
+}
+
+void ExpandNode(std::unique_ptr<Expr>& root)
+{
 	if (!root->IsMul())
 		return;
 
+	// Polynomial factors are multiplied out term by term, without cloning subtrees
+	if (poly::Expand(root))
+		return;
+
 	if (root->IsGeneric())
 		MultiplyGenNode(root);
 	else
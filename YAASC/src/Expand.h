@@ -2,10 +2,12 @@
 
 #include "Expr.h"
 #include "TreeUtil.h"
+#include "Polynomial.h"
 
 namespace algebra {
 
 void Expand(std::unique_ptr<Expr>& root);
+void ExpandNode(std::unique_ptr<Expr>& root);
 void MultiplyBinNode(std::unique_ptr<Expr>& root);
 void MultiplyGenNode(std::unique_ptr<Expr>& root);
 
@@ -1,5 +1,38 @@
 #include "Expr.h"
 
+// Each node is prefixed with a header that tells whether it lives in an arena or on the heap
+static constexpr std::size_t node_header = alignof(std::max_align_t);
+
+void* Expr::operator new(std::size_t size)
+{
+	NodeArena* arena = NodeArena::Current();
+	char* memory = nullptr;
+
+	if (arena)
+		memory = static_cast<char*>(arena->Allocate(size + node_header));
+	else
+		memory = static_cast<char*>(::operator new(size + node_header));
+
+	*reinterpret_cast<bool*>(memory) = arena != nullptr;
+
+	return memory + node_header;
+}
+
+// Arena nodes are released together with their arena
+void Expr::operator delete(void* ptr)
+{
+	if (!ptr)
+		return;
+
+	char* memory = static_cast<char*>(ptr) - node_header;
+
+	if (!*reinterpret_cast<bool*>(memory))
+		::operator delete(memory);
+}
+
+thread_local unsigned Expr::s_generation = 0;
+thread_local unsigned Expr::s_settled_below = 0;
+
 bool Expr::HasLeftChild()
 {
 	if (m_left)
@@ -129,12 +162,127 @@ void Expr::SwapChildren()
 	std::unique_ptr<Expr> new_right = std::move(m_left);
 	m_left = std::move(m_right);
 	m_right = std::move(new_right);
+	Rehash();
+}
+
+/* Structural hash of the node from its own value and the cached hashes of its children.
+*  Passes that replace a child through a reference (root->Left(), ChildAt(i)...) call this
+*  on the parent afterwards, so that the hash of every visited node stays up to date.
+*/
+void Expr::Rehash()
+{
+	std::size_t seed = ValueHash();
+
+	if (IsFunc())
+	{
+		HashCombine(seed, Param() ? Param()->Hash() : 0);
+
+		if (IsLog())
+			HashCombine(seed, Base() ? Base()->Hash() : 0);
+	}
+	else if (IsGeneric())
+	{
+		HashCombine(seed, 1);
+
+		for (int i = 0; i < ChildrenSize(); i++)
+			HashCombine(seed, ChildAt(i) ? ChildAt(i)->Hash() : 0);
+	}
+	else if (!IsTerminal())
+	{
+		HashCombine(seed, m_left ? m_left->Hash() : 0);
+		HashCombine(seed, m_right ? m_right->Hash() : 0);
+	}
+
+	SetHash(seed);
+}
+
+// Stamps the node, so that Simplify() visits it and its ancestors again
+void Expr::SetHash(std::size_t hash)
+{
+	if (hash == m_hash)
+		return;
+
+	m_hash = hash;
+	m_generation = s_generation;
+}
+
+void Associative::AddChild(std::unique_ptr<Expr> expr)
+{
+	m_children.push_back(std::move(expr));
+
+	// Generic hash is a fold over the children, so appending only extends it
+	if (m_children.size() == 1)
+		Rehash();
+	else
+	{
+		std::size_t seed = m_hash;
+		HashCombine(seed, m_children.back() ? m_children.back()->Hash() : 0);
+		SetHash(seed);
+	}
 }
 
 void Associative::SetChildAt(int i, std::unique_ptr<Expr> child)
 {
 	if (i < ChildrenSize())
+	{
 		m_children[i] = std::move(child);
+		Rehash();
+	}
+}
+
+// Total order on the structure of two trees: kind, value, then the children from left to right
+static int CompareStructure(const std::unique_ptr<Expr>& expr_a, const std::unique_ptr<Expr>& expr_b)
+{
+	if (!expr_a || !expr_b)
+		return (bool)expr_a - (bool)expr_b;
+
+	if (expr_a->ExpressionType() != expr_b->ExpressionType())
+		return expr_a->ExpressionType() < expr_b->ExpressionType() ? -1 : 1;
+
+	if (expr_a->IsVar())
+	{
+		if (expr_a->Symbol() == expr_b->Symbol())
+			return 0;
+
+		return symbol::Less(expr_a->Symbol(), expr_b->Symbol()) ? -1 : 1;
+	}
+	else if (expr_a->IsInteger())
+		return Compare(expr_a->bValue(), expr_b->bValue());
+	else if (expr_a->IsTerminal())
+		return expr_a->Name().compare(expr_b->Name());
+
+	if (expr_a->RespectTo() != expr_b->RespectTo())
+		return expr_a->RespectTo() < expr_b->RespectTo() ? -1 : 1;
+
+	if (expr_a->IsGeneric() != expr_b->IsGeneric())
+		return expr_a->IsGeneric() ? 1 : -1;
+
+	int order = 0;
+
+	if (expr_a->IsFunc())
+	{
+		order = CompareStructure(expr_a->Param(), expr_b->Param());
+
+		if (order == 0 && expr_a->IsLog())
+			order = CompareStructure(expr_a->Base(), expr_b->Base());
+	}
+	else if (expr_a->IsGeneric())
+	{
+		if (expr_a->ChildrenSize() != expr_b->ChildrenSize())
+			return expr_a->ChildrenSize() < expr_b->ChildrenSize() ? -1 : 1;
+
+		for (int i = 0; i < expr_a->ChildrenSize() && order == 0; i++)
+			order = CompareStructure(expr_a->ChildAt(i), expr_b->ChildAt(i));
+	}
+	else
+	{
+		order = CompareStructure(expr_a->Left(), expr_b->Left());
+
+		if (order == 0)
+			order = CompareStructure(expr_a->Right(), expr_b->Right());
+	}
+
+	return order;
 }
 
 void Associative::SortChildren()
@@ -145,10 +293,25 @@ void Associative::SortChildren()
 			ChildAt(i)->SortChildren();
 	}
 
-	std::sort(m_children.begin(), m_children.end(),
+	// Terms with the same leftmost name are ordered by their whole structure, so that
+	// sorting a sorted node leaves it as it is and Simplify() can't cycle through orders
+	std::stable_sort(m_children.begin(), m_children.end(),
 		[](std::unique_ptr<Expr> const& a, std::unique_ptr<Expr> const& b) {
-			return LeftmostChild(a)->Name() < LeftmostChild(b)->Name();
+			const std::unique_ptr<Expr>& leftmost_a = LeftmostChild(a);
+			const std::unique_ptr<Expr>& leftmost_b = LeftmostChild(b);
+
+			if (leftmost_a->IsVar() && leftmost_b->IsVar())
+			{
+				if (leftmost_a->Symbol() != leftmost_b->Symbol())
+					return symbol::Less(leftmost_a->Symbol(), leftmost_b->Symbol());
+			}
+			else if (leftmost_a->Name() != leftmost_b->Name())
+				return leftmost_a->Name() < leftmost_b->Name();
+
+			return CompareStructure(a, b) < 0;
 		});
+
+	Rehash();
 }
 
 void Associative::SortMulChildren()
@@ -164,26 +327,25 @@ void Associative::SortAddChildren()
 void Associative::ReverseChildren()
 {
 	std::reverse(m_children.begin(), m_children.end());
+	Rehash();
 }
 
 void Associative::RemoveChild(int i)
 {
 	if (i < ChildrenSize())
+	{
 		m_children.erase(m_children.begin() + i);
+		Rehash();
+	}
 }
 
 void Associative::RemoveChildren(int from, int to)
 {
 	if (to <= ChildrenSize())
+	{
 		m_children.erase(m_children.begin() + from, m_children.begin() + to);
-}
-
-bool Associative::IsGeneric()
-{
-	if (!m_children.empty())
-		return true;
-
-	return false;
+		Rehash();
+	}
 }
 
 std::unique_ptr<Expr>& Associative::ChildAt(int i)
@@ -194,74 +356,77 @@ std::unique_ptr<Expr>& Associative::ChildAt(int i)
 	return Left();
 }
 
-bool Integer::IsZero()
+// Floats are compared by their printed name, so that values within rounding count as equal
+bool Expr::IsZero() const
 {
-	if (Name() == "0")
-		return true;
-
-	return false;
-}
-
-bool Integer::IsOne()
-{
-	if (Name() == "1")
-		return true;
-
-	return false;
-}
-
-bool Integer::IsNegOne()
-{
-	if (Name() == "-1")
-		return true;
-
-	return false;
+	switch (m_type)
+	{
+	case ExprType::INTEGER:
+		return static_cast<const Integer*>(this)->Atom() == 0;
+	case ExprType::FLOAT:
+		return static_cast<const Float*>(this)->Float::Name() == "0";
+	default:
+		return false;
+	}
 }
 
-bool Integer::IsNeg()
+bool Expr::IsOne() const
 {
-	if (Name()[0] == '-')
-		return true;
-
-	return false;
+	switch (m_type)
+	{
+	case ExprType::INTEGER:
+		return static_cast<const Integer*>(this)->Atom() == 1;
+	case ExprType::FLOAT:
+		return static_cast<const Float*>(this)->Float::Name() == "1";
+	default:
+		return false;
+	}
 }
 
-bool Float::IsZero()
+bool Expr::IsNegOne() const
 {
-	if (Name() == "0")
-		return true;
-
-	return false;
-
+	switch (m_type)
+	{
+	case ExprType::INTEGER:
+		return static_cast<const Integer*>(this)->Atom() == -1;
+	case ExprType::FLOAT:
+		return static_cast<const Float*>(this)->Float::Name() == "-1";
+	default:
+		return false;
+	}
 }
 
-bool Float::IsOne()
+bool Expr::IsNeg() const
 {
-	if (Name() == "1")
-		return true;
-
-	return false;
+	switch (m_type)
+	{
+	case ExprType::INTEGER:
+		return static_cast<const Integer*>(this)->Atom() < 0;
+	case ExprType::FLOAT:
+		return static_cast<const Float*>(this)->Float::Name()[0] == '-';
+	case ExprType::FRACTION:
+		return static_cast<const Fraction*>(this)->Atom().Sign() < 0;
+	default:
+		return false;
+	}
 }
 
-bool Float::IsNegOne()
+// Integral floats hash like integers, since Float 2 and Integer 2 have the same name
+std::size_t Float::HashValue(float value)
 {
-	if (Name() == "-1")
-		return true;
+	std::string name = Format(value);
 
-	return false;
-}
+	std::size_t first_digit = !name.empty() && name[0] == '-' ? 1 : 0;
 
-bool Float::IsNeg()
-{
-	if (Name()[0] == '-')
-		return true;
+	if (first_digit < name.size() && name.find_first_not_of("0123456789", first_digit) == std::string::npos)
+		return BigInt::FromString(name).Hash();
 
-	return false;
+	return std::hash<std::string>()(name);
 }
 
-std::string Float::Name() const // FIXME: This could probably be simplified
+std::string Float::Format(float value) // FIXME: This could probably be simplified
 {
-	std::string float_str = std::to_string(m_atom);
+	std::string float_str = std::to_string(value);
 	std::string new_str = "";
 
 	int end = float_str.length();
@@ -287,14 +452,6 @@ std::string Float::Name() const // FIXME: This could probably be simplified
 	return new_str;
 }
 
-bool Fraction::IsNeg()
-{
-	if (fValue() < 0)
-		return true;
-
-	return false;
-}
-
 std::ostream& operator<< (std::ostream& out, const std::unique_ptr<Expr>& expr)
 {
 	out << expr->Name();
@@ -313,6 +470,10 @@ bool operator!= (const std::unique_ptr<Expr>& expr_a, const std::unique_ptr<Expr
 
 bool SameExpressions(const std::unique_ptr<Expr>& expr_a, const std::unique_ptr<Expr>& expr_b)
 {
+	// Different hashes can't be the same expression, trees are walked only when hashes collide
+	if (expr_a && expr_b && expr_a->Hash() != expr_b->Hash())
+		return false;
+
 	bool same_expressions = true;
 	CheckExpressions(expr_a, expr_b, same_expressions);
 
@@ -336,6 +497,9 @@ void CheckExpressions(const std::unique_ptr<Expr>& expr_a, const std::unique_ptr
 	if (expr_a->IsFunc() && expr_b->IsFunc())
 		CheckExpressions(expr_a->Param(), expr_b->Param(), same);
 
+	if (expr_a->IsLog() && expr_b->IsLog())
+		CheckExpressions(expr_a->Base(), expr_b->Base(), same);
+
 	if (expr_a->IsGeneric() && expr_b->IsGeneric())
 	{
 		if (expr_a->ChildrenSize() != expr_b->ChildrenSize())
@@ -351,7 +515,7 @@ void CheckExpressions(const std::unique_ptr<Expr>& expr_a, const std::unique_ptr
 	else if (expr_a->IsGeneric() && !expr_b->IsGeneric()) // FIXME: Generic and binary nodes could be the same in some cases
 		same = false;
 
-	if (expr_a->Name() != expr_b->Name())
+	if (expr_a->Name() != expr_b->Name() || expr_a->RespectTo() != expr_b->RespectTo())
 		same = false;
 }
 
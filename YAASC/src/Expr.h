@@ -9,6 +9,10 @@
 #include <memory>
 #include <algorithm>
 
+#include "NodeArena.h"
+#include "Symbol.h"
+#include "Rational.h"
+
 enum class ExprType
 {
 	MUL,
@@ -18,6 +22,7 @@ enum class ExprType
 	FUNC,
 	FAC,
 	LOG,
+	LN,
 	SIN,
 	COS,
 	TAN,
@@ -33,15 +38,76 @@ enum class ExprType
 	NIL
 };
 
+inline void HashCombine(std::size_t& seed, std::size_t value)
+{
+	seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+}
+
+// Properties shared by several node kinds, looked up from the kind tag of a node
+namespace kind {
+
+constexpr unsigned terminal = 1 << 0;
+constexpr unsigned number = 1 << 1;
+constexpr unsigned variable = 1 << 2;
+constexpr unsigned special = 1 << 3;
+constexpr unsigned function = 1 << 4;
+constexpr unsigned logarithm = 1 << 5;
+constexpr unsigned trigonometric = 1 << 6;
+constexpr unsigned associative = 1 << 7;
+
+constexpr unsigned Traits(ExprType type)
+{
+	switch (type)
+	{
+	case ExprType::INTEGER:
+	case ExprType::FLOAT:
+	case ExprType::FRACTION:
+		return terminal | number;
+	case ExprType::VARIABLE:
+		return terminal | variable;
+	case ExprType::PI:
+	case ExprType::e:
+		return terminal | variable | special;
+	case ExprType::MUL:
+	case ExprType::ADD:
+		return associative;
+	case ExprType::FAC:
+	case ExprType::DERIVATIVE:
+	case ExprType::INTEGRAL:
+		return function;
+	case ExprType::LOG:
+	case ExprType::LN:
+		return function | logarithm;
+	case ExprType::SIN:
+	case ExprType::COS:
+	case ExprType::TAN:
+		return function | trigonometric;
+	default:
+		return 0;
+	}
+}
+
+} // namespace kind
+
 class Expr
 {
 private:
 	std::unique_ptr<Expr> m_left;
 	std::unique_ptr<Expr> m_right;
+	ExprType m_type; // Kind tag, the Is*() predicates dispatch on it without virtual calls
+
+protected:
+	std::size_t m_hash{ 0 }; // Structural hash, computed when the node is built and refreshed by Rehash()
+	unsigned m_generation{ 0 }; // Generation in which the hash last changed
+
+	static thread_local unsigned s_generation;
+	static thread_local unsigned s_settled_below;
+
+	void SetHash(std::size_t hash);
 
 public:
-	Expr(std::unique_ptr<Expr> left = nullptr, std::unique_ptr<Expr> right = nullptr)
-		: m_left(std::move(left)), m_right(std::move(right))
+	Expr(ExprType type, std::unique_ptr<Expr> left = nullptr, std::unique_ptr<Expr> right = nullptr)
+		: m_left(std::move(left)), m_right(std::move(right)), m_type(type)
 	{
 	}
 
@@ -49,40 +115,43 @@ public:
 	{
 	}
 
+	static void* operator new(std::size_t size);
+	static void operator delete(void* ptr);
+
 	virtual int Eval(std::map<std::string, int> env) = 0;
 	virtual std::string Name() const = 0;
 
 	virtual int ChildrenSize() const { return 0; }
-	virtual ExprType ExpressionType() const { return ExprType::NIL; }
-
-	virtual bool IsTerminal() const { return false; }
-	virtual bool IsFunc() const { return false; }
-	virtual bool IsFac() const { return false; }
-	virtual bool IsLog() const { return false; }
-	virtual bool IsLn() const { return false; }
-	virtual bool IsTrig() const { return false; }
-	virtual bool IsSin() const { return false;}
-	virtual bool IsCos() const { return false; }
-	virtual bool IsTan() const { return false; }
-	virtual bool IsDerivative() const{ return false; }
-	virtual bool IsIntegral() const { return false; }
-	virtual bool IsAssociative() const { return false; }
-	virtual bool IsVar() const { return false; }
-	virtual bool IsInteger() const { return false; }
-	virtual bool IsFloat() const { return false; }
-	virtual bool IsFraction() const { return false; }
-	virtual bool IsNumber() const { return false; }
-	virtual bool IsMul() const { return false; }
-	virtual bool IsAdd() const { return false; }
-	virtual bool IsPow() const { return false; }
-	virtual bool IsSpecial() const { return false; }
-	virtual bool IsPi() const { return false; }
-	virtual bool IsE() const { return false; }
-	virtual bool IsGeneric() { return false; }
-	virtual bool IsZero() { return false; }
-	virtual bool IsOne() { return false; }
-	virtual bool IsNegOne() { return false; }
-	virtual bool IsNeg() { return false; }
+	ExprType ExpressionType() const { return m_type; }
+
+	bool IsTerminal() const { return kind::Traits(m_type) & kind::terminal; }
+	bool IsFunc() const { return kind::Traits(m_type) & kind::function; }
+	bool IsFac() const { return m_type == ExprType::FAC; }
+	bool IsLog() const { return kind::Traits(m_type) & kind::logarithm; }
+	bool IsLn() const { return m_type == ExprType::LN; }
+	bool IsTrig() const { return kind::Traits(m_type) & kind::trigonometric; }
+	bool IsSin() const { return m_type == ExprType::SIN; }
+	bool IsCos() const { return m_type == ExprType::COS; }
+	bool IsTan() const { return m_type == ExprType::TAN; }
+	bool IsDerivative() const { return m_type == ExprType::DERIVATIVE; }
+	bool IsIntegral() const { return m_type == ExprType::INTEGRAL; }
+	bool IsAssociative() const { return kind::Traits(m_type) & kind::associative; }
+	bool IsVar() const { return kind::Traits(m_type) & kind::variable; }
+	bool IsInteger() const { return m_type == ExprType::INTEGER; }
+	bool IsFloat() const { return m_type == ExprType::FLOAT; }
+	bool IsFraction() const { return m_type == ExprType::FRACTION; }
+	bool IsNumber() const { return kind::Traits(m_type) & kind::number; }
+	bool IsMul() const { return m_type == ExprType::MUL; }
+	bool IsAdd() const { return m_type == ExprType::ADD; }
+	bool IsPow() const { return m_type == ExprType::POW; }
+	bool IsSpecial() const { return kind::Traits(m_type) & kind::special; }
+	bool IsPi() const { return m_type == ExprType::PI; }
+	bool IsE() const { return m_type == ExprType::e; }
+	bool IsGeneric() const;
+	bool IsZero() const;
+	bool IsOne() const;
+	bool IsNegOne() const;
+	bool IsNeg() const;
 
 	virtual bool HasLeftChild();
 	virtual bool HasRightChild();
@@ -97,18 +166,45 @@ public:
 	virtual bool RightIsTerminal();
 
 	virtual int iValue() const { return 0; }
-	virtual int Numerator() const { return 0; }
-	virtual int Denominator() const { return 0; }
+	virtual BigInt bValue() const { return BigInt(iValue()); }
+	virtual Rational rValue() const { return Rational(bValue()); }
 
 	virtual float fValue() const { return 0.0f; }
 
+	virtual std::size_t ValueHash() const { return std::hash<std::string>()(Name()); }
+	std::size_t Hash() const { return m_hash; }
+	void Rehash();
+
+	/* Dirty tracking for the fixpoint loop of yaasc::Simplify(). A node is stamped with the
+	*  current generation whenever it is built or its hash changes, and since passes rehash
+	*  on the way back up, the ancestors of a rewritten node are stamped with it. A subtree
+	*  that went through a whole iteration without being stamped is settled: running the
+	*  passes over it again gives the same tree, so they can skip it.
+	*/
+	unsigned Generation() const { return m_generation; }
+	bool Settled() const { return m_generation < s_settled_below; }
+
+	static unsigned NextGeneration() { return ++s_generation; }
+	static void SettleBefore(unsigned generation) { s_settled_below = generation; }
+
+	// Generations are per thread, threads that help with a pass continue from the caller's state
+	struct GenerationState
+	{
+		unsigned generation;
+		unsigned settled_below;
+	};
+
+	static GenerationState CurrentGenerationState() { return { s_generation, s_settled_below }; }
+	static void SetGenerationState(GenerationState state) { s_generation = state.generation; s_settled_below = state.settled_below; }
+
 	virtual std::unique_ptr<Expr>& Left() { return m_left; }
 	virtual std::unique_ptr<Expr>& Right(){ return m_right; }
 	virtual std::unique_ptr<Expr>& ChildAt(int i) { (void)i; return m_left; }
 	virtual std::unique_ptr<Expr>& Param() { return m_left; }
 	virtual std::unique_ptr<Expr>& Base() { return m_left; }
 
-	virtual std::string RespectTo() const { return ""; }
+	virtual symbol::Id RespectTo() const { return symbol::none; }
+	symbol::Id Symbol() const;
 
 	virtual void SwapChildren();
 	virtual void SortChildren() {}
@@ -120,8 +216,8 @@ public:
 	virtual void RemoveChild(int i) { (void)i; }
 	virtual void AddChild(std::unique_ptr<Expr> child) { (void)child; }
 	virtual void SetChildAt(int i, std::unique_ptr<Expr> child) { (void)i; }
-	virtual void SetLeft(std::unique_ptr<Expr> expr) { m_left = std::move(expr); }
-	virtual void SetRight(std::unique_ptr<Expr> expr) { m_right = std::move(expr); }
+	virtual void SetLeft(std::unique_ptr<Expr> expr) { m_left = std::move(expr); Rehash(); }
+	virtual void SetRight(std::unique_ptr<Expr> expr) { m_right = std::move(expr); Rehash(); }
 	virtual void SetBase(std::unique_ptr<Expr> expr) {}
 
 	friend std::ostream& operator<< (std::ostream& out, const std::unique_ptr<Expr>& expr);
@@ -143,7 +239,8 @@ protected:
 	T m_atom;
 
 public:
-	Atomic(T atom) : m_atom(atom)
+	Atomic(ExprType type, T atom)
+		: Expr(type), m_atom(atom)
 	{
 	}
 
@@ -151,42 +248,46 @@ public:
 	{
 	}
 
-	bool IsTerminal() const { return true; }
+	const T& Atom() const { return m_atom; }
+
 };
 
-class Integer : public Atomic<int>
+class Integer : public Atomic<BigInt>
 {
 public:
 	Integer(int value)
-		: Atomic(value)
+		: Atomic(ExprType::INTEGER, BigInt(value))
 	{
+		Rehash();
+	}
+
+	Integer(BigInt value)
+		: Atomic(ExprType::INTEGER, std::move(value))
+	{
+		Rehash();
 	}
 
 	int Eval(std::map<std::string, int> env)
 	{
 		(void)env;
-		return m_atom;
+		return m_atom.ToInt();
 	}
 
-	int iValue() const { return m_atom; }
-	float fValue() const { return static_cast<float>(m_atom); }
+	int iValue() const { return m_atom.ToInt(); }
+	BigInt bValue() const { return m_atom; }
+	float fValue() const { return static_cast<float>(m_atom.ToDouble()); }
+	std::size_t ValueHash() const { return m_atom.Hash(); }
 
-	std::string Name() const { return std::to_string(m_atom); }
-	ExprType ExpressionType() const { return ExprType::INTEGER; }
-	bool IsInteger() const { return true; }
-	bool IsNumber() const { return true; }
-	bool IsZero();
-	bool IsOne();
-	bool IsNegOne();
-	bool IsNeg();
+	std::string Name() const { return m_atom.ToString(); }
 };
 
 class Float : public Atomic<float>
 {
 public:
 	Float(float value)
-		: Atomic(value)
+		: Atomic(ExprType::FLOAT, value)
 	{
+		Rehash();
 	}
 
 	int Eval(std::map<std::string, int> env)
@@ -197,65 +298,79 @@ public:
 
 	float fValue() const { return m_atom; }
 	int iValue() const { return static_cast<int>(m_atom); }
+	std::size_t ValueHash() const { return HashValue(m_atom); }
+
+	std::string Name() const { return Format(m_atom); }
 
-	std::string Name() const;
-	ExprType ExpressionType() const { return ExprType::FLOAT; }
-	bool IsFloat() const { return true; }
-	bool IsNumber() const { return true; }
-	bool IsZero();
-	bool IsOne();
-	bool IsNegOne();
-	bool IsNeg();
+	static std::string Format(float value);
+	static std::size_t HashValue(float value);
 };
 
-class Fraction : public Atomic<std::string>
+class Fraction : public Atomic<Rational>
 {
-private:
-	int m_numerator;
-	int m_denominator;
-
 public:
 	Fraction(int numerator, int denominator)
-		: m_numerator(numerator), m_denominator(denominator),
-		  Atomic(std::to_string(numerator) + "/" + std::to_string(denominator))
+		: Atomic(ExprType::FRACTION, Rational(numerator, denominator))
+	{
+		Rehash();
+	}
+
+	Fraction(Rational value)
+		: Atomic(ExprType::FRACTION, std::move(value))
 	{
+		Rehash();
 	}
 
-	int Numerator() const { return m_numerator; }
-	int Denominator() const { return m_denominator; }
-	int iValue() const { return m_numerator / m_denominator; }
-	float fValue() const { return static_cast<float>(m_numerator * 1.0f / m_denominator); }
+	int iValue() const { return (m_atom.Numerator() / m_atom.Denominator()).ToInt(); }
+	BigInt bValue() const { return m_atom.Numerator() / m_atom.Denominator(); }
+	Rational rValue() const { return m_atom; }
+	float fValue() const { return static_cast<float>(m_atom.ToDouble()); }
 
-	int Eval(std::map<std::string, int> env) { return m_numerator / m_denominator; }
-	bool IsFraction() const{ return true; }
-	bool IsNumber() const { return true; }
-	bool IsNeg();
-	std::string Name() const { return m_atom; }
+	int Eval(std::map<std::string, int> env) { return iValue(); }
+	std::string Name() const { return m_atom.ToString(); }
 };
 
-class Var : public Atomic<std::string>
+class Var : public Atomic<symbol::Id>
 {
+protected:
+	Var(std::string name, ExprType type)
+		: Atomic(type, symbol::Intern(name))
+	{
+		Rehash();
+	}
+
 public:
 	Var(std::string name)
-		: Atomic(name)
+		: Atomic(ExprType::VARIABLE, symbol::Intern(name))
+	{
+		Rehash();
+	}
+
+	Var(symbol::Id id)
+		: Atomic(ExprType::VARIABLE, id)
 	{
+		Rehash();
 	}
 
 	virtual ~Var()
 	{
 	}
 
-	int Eval(std::map<std::string, int> env) { return env.at(m_atom); }
-	std::string Name() const { return m_atom; }
-	ExprType ExpressionType() const { return ExprType::VARIABLE; }
-	bool IsVar() const { return true; }
+	int Eval(std::map<std::string, int> env) { return env.at(Name()); }
+	std::string Name() const { return symbol::Name(m_atom); }
+	std::size_t ValueHash() const { return std::hash<symbol::Id>()(m_atom); }
 };
 
+inline symbol::Id Expr::Symbol() const
+{
+	return IsVar() ? static_cast<const Var*>(this)->Atom() : symbol::none;
+}
+
 class Special : public Var
 {
 public:
-	Special(std::string name)
-		: Var(name)
+	Special(std::string name, ExprType type)
+		: Var(name, type)
 	{
 	}
 
@@ -263,7 +378,6 @@ public:
 	{
 	}
 
-	bool IsSpecial() const { return true; }
 };
 
 class Pi : public Special
@@ -272,27 +386,23 @@ private:
 	const float m_pi{ 3.14159f };
 
 public:
-	Pi() : Special("pi")
+	Pi() : Special("pi", ExprType::PI)
 	{
 	}
 
 	float fValue() const { return m_pi; }
 
 	int Eval(std::map<std::string, int> env) { return 0; }
-	ExprType ExpressionType() const { return ExprType::PI; }
-	bool IsPi() const { return true; }
 };
 
 class E : public Special
 {
 public:
-	E() : Special("e")
+	E() : Special("e", ExprType::e)
 	{
 	}
 
 	int Eval(std::map<std::string, int> env) { return 0; }
-	ExprType ExpressionType() const { return ExprType::e; }
-	bool IsE() const { return true; }
 };
 
 class Associative : public Expr
@@ -301,8 +411,8 @@ protected:
 	std::vector<std::unique_ptr<Expr>> m_children;
 
 public:
-	Associative(std::unique_ptr<Expr> left = nullptr, std::unique_ptr<Expr> right = nullptr)
-		: Expr(std::move(left), std::move(right))
+	Associative(ExprType type, std::unique_ptr<Expr> left = nullptr, std::unique_ptr<Expr> right = nullptr)
+		: Expr(type, std::move(left), std::move(right))
 	{
 	}
 
@@ -310,64 +420,64 @@ public:
 	{
 	}
 
-	void ClearChildren() { m_children.clear(); }
+	void ClearChildren() { m_children.clear(); Rehash(); }
 	void SortChildren();
 	void SortAddChildren();
 	void SortMulChildren();
 	void ReverseChildren();
 	void RemoveChildren(int from, int to);
 	void RemoveChild(int i);
-	void AddChild(std::unique_ptr<Expr> expr) { m_children.push_back(std::move(expr)); }
+	void AddChild(std::unique_ptr<Expr> expr);
 	void SetChildAt(int i, std::unique_ptr<Expr> child);
 
 	int ChildrenSize() const { return (int)m_children.size(); }
 
 	std::unique_ptr<Expr>& ChildAt(int i);
 
-	bool IsAssociative() const { return true; }
-	bool IsGeneric();
 };
 
+inline bool Expr::IsGeneric() const
+{
+	return IsAssociative() && static_cast<const Associative*>(this)->Associative::ChildrenSize() != 0;
+}
+
 class Mul : public Associative
 {
 public:
 	Mul(std::unique_ptr<Expr> left = nullptr, std::unique_ptr<Expr> right = nullptr)
-		: Associative(std::move(left), std::move(right))
+		: Associative(ExprType::MUL, std::move(left), std::move(right))
 	{
+		Rehash();
 	}
 
 	int Eval(std::map<std::string, int> env) { return Left()->Eval(env) * Right()->Eval(env); }
 	std::string Name() const { return "*"; }
-	ExprType ExpressionType() const { return ExprType::MUL; }
-	bool IsMul() const { return true; }
 };
 
 class Add : public Associative
 {
 public:
 	Add(std::unique_ptr<Expr> left = nullptr, std::unique_ptr<Expr> right = nullptr)
-		: Associative(std::move(left), std::move(right))
+		: Associative(ExprType::ADD, std::move(left), std::move(right))
 	{
+		Rehash();
 	}
 
 	int Eval(std::map<std::string, int> env) { return Left()->Eval(env) + Right()->Eval(env); }
 	std::string Name() const { return "+"; }
-	ExprType ExpressionType() const { return ExprType::ADD; }
-	bool IsAdd() const { return true; }
 };
 
 class Pow : public Expr
 {
 public:
 	Pow(std::unique_ptr<Expr> left, std::unique_ptr<Expr> right)
-		: Expr(std::move(left), std::move(right))
+		: Expr(ExprType::POW, std::move(left), std::move(right))
 	{
+		Rehash();
 	}
 
 	int Eval(std::map<std::string, int> env) { return (int)std::pow(Left()->Eval(env), Right()->Eval(env)); }
 	std::string Name() const { return "^"; }
-	ExprType ExpressionType() const { return ExprType::POW; }
-	bool IsPow() const { return true; }
 };
 
 class Func : public Expr
@@ -376,8 +486,8 @@ protected:
 	std::unique_ptr<Expr> m_param;
 
 public: 
-	Func(std::unique_ptr<Expr> param)
-		: Expr(nullptr, nullptr), m_param(std::move(param))
+	Func(ExprType type, std::unique_ptr<Expr> param)
+		: Expr(type, nullptr, nullptr), m_param(std::move(param))
 	{
 	}
 
@@ -386,19 +496,18 @@ public:
 	}
 
 	std::unique_ptr<Expr>& Param() { return m_param; }
-	bool IsFunc() const { return true; }
 };
 
 class Fac : public Func
 {
 public:
 	Fac(std::unique_ptr<Expr> param)
-		: Func(std::move(param))
+		: Func(ExprType::FAC, std::move(param))
 	{
+		Rehash();
 	}
 
 	int Eval(std::map<std::string, int> env) { return 0; }
-	bool IsFac() const { return true; }
 	std::string Name() const { return "!"; }
 };
 
@@ -407,20 +516,25 @@ class Log : public Func
 protected:
 	std::unique_ptr<Expr> m_base;
 
+	Log(ExprType type, std::unique_ptr<Expr> param, std::unique_ptr<Expr> base)
+		: m_base(std::move(base)), Func(type, std::move(param))
+	{
+	}
+
 public:
 	Log(std::unique_ptr<Expr> param, std::unique_ptr<Expr> base)
-		: m_base(std::move(base)), Func(std::move(param))
+		: m_base(std::move(base)), Func(ExprType::LOG, std::move(param))
 	{
+		Rehash();
 	}
 
 	virtual ~Log()
 	{
 	}
 
-	void SetBase(std::unique_ptr<Expr> expr) { m_base = std::move(expr); }
+	void SetBase(std::unique_ptr<Expr> expr) { m_base = std::move(expr); Rehash(); }
 	int Eval(std::map<std::string, int> env) { return 0; }
 	std::unique_ptr<Expr>& Base() { return m_base; }
-	bool IsLog() const { return true; }
 	std::string Name() const { return "log"; }
 };
 
@@ -428,21 +542,21 @@ class Ln : public Log
 {
 public:
 	Ln(std::unique_ptr<Expr> param)
-		: Log(std::move(param),
+		: Log(ExprType::LN, std::move(param),
 		  std::move(std::make_unique<Pow>(std::make_unique<E>(), std::make_unique<Integer>(1))))
 	{
+		Rehash();
 	}
 
 	int Eval(std::map<std::string, int> env) { return 0; }
-	bool IsLn() const { return true; }
 	std::string Name() const { return "ln"; }
 };
 
 class Trig : public Func
 {
 public:
-	Trig(std::unique_ptr<Expr> param)
-		: Func(std::move(param))
+	Trig(ExprType type, std::unique_ptr<Expr> param)
+		: Func(type, std::move(param))
 	{
 	}
 
@@ -450,19 +564,18 @@ public:
 	{
 	}
 
-	bool IsTrig() const { return true; }
 };
 
 class Sin : public Trig
 {
 public:
 	Sin(std::unique_ptr<Expr> param)
-		: Trig(std::move(param))
+		: Trig(ExprType::SIN, std::move(param))
 	{
+		Rehash();
 	}
 
 	int Eval(std::map<std::string, int> env) { return 0; }
-	bool IsSin() const { return true; }
 	std::string Name() const { return "sin"; }
 };
 
@@ -470,12 +583,12 @@ class Cos : public Trig
 {
 public:
 	Cos(std::unique_ptr<Expr> param)
-		: Trig(std::move(param))
+		: Trig(ExprType::COS, std::move(param))
 	{
+		Rehash();
 	}
 
 	int Eval(std::map<std::string, int> env) { return 0; }
-	bool IsCos() const { return true; }
 	std::string Name() const { return "cos"; }
 };
 
@@ -483,44 +596,75 @@ class Tan : public Trig
 {
 public:
 	Tan(std::unique_ptr<Expr> param)
-		: Trig(std::move(param))
+		: Trig(ExprType::TAN, std::move(param))
 	{
+		Rehash();
 	}
 
 	int Eval(std::map<std::string, int> env) { return 0; }
-	bool IsTan() const { return true; }
 	std::string Name() const { return "tan"; }
 };
 
 class Derivative : public Func
 {
 private:
-	std::string m_respect_to;
+	symbol::Id m_respect_to;
 
 public:
 	Derivative(std::unique_ptr<Expr> param, std::string respect_to)
-		: m_respect_to(respect_to), Func(std::move(param))
+		: Func(ExprType::DERIVATIVE, std::move(param)), m_respect_to(symbol::Intern(respect_to))
+	{
+		Rehash();
+	}
+
+	Derivative(std::unique_ptr<Expr> param, symbol::Id respect_to)
+		: Func(ExprType::DERIVATIVE, std::move(param)), m_respect_to(respect_to)
 	{
+		Rehash();
 	}
 
-	std::string RespectTo() const{ return m_respect_to; }
+	symbol::Id RespectTo() const { return m_respect_to; }
+
 	int Eval(std::map<std::string, int> env) { return 0; }
-	bool IsDerivative() const { return true; }
 	std::string Name() const { return "D"; }
+
+	std::size_t ValueHash() const
+	{
+		std::size_t seed = std::hash<std::string>()(Name());
+		HashCombine(seed, std::hash<symbol::Id>()(m_respect_to));
+
+		return seed;
+	}
 };
 
 class Integral : public Func
 {
 private:
-	std::string m_respect_to;
+	symbol::Id m_respect_to;
 
 public:
 	Integral(std::unique_ptr<Expr> param, std::string respect_to)
-		: m_respect_to(respect_to), Func(std::move(param))
+		: Func(ExprType::INTEGRAL, std::move(param)), m_respect_to(symbol::Intern(respect_to))
 	{
+		Rehash();
 	}
 
+	Integral(std::unique_ptr<Expr> param, symbol::Id respect_to)
+		: Func(ExprType::INTEGRAL, std::move(param)), m_respect_to(respect_to)
+	{
+		Rehash();
+	}
+
+	symbol::Id RespectTo() const { return m_respect_to; }
+
 	int Eval(std::map<std::string, int> env) { return 0; }
-	bool IsIntegral() const { return true; }
 	std::string Name() const { return "I"; }
+
+	std::size_t ValueHash() const
+	{
+		std::size_t seed = std::hash<std::string>()(Name());
+		HashCombine(seed, std::hash<symbol::Id>()(m_respect_to));
+
+		return seed;
+	}
 };
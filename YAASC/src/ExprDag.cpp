@@ -0,0 +1,161 @@
+#include "ExprDag.h"
+
+namespace dag {
+
+static std::size_t HashNode(const Node& node)
+{
+	std::size_t seed = std::hash<int>()(static_cast<int>(node.type));
+
+	HashCombine(seed, std::hash<symbol::Id>()(node.symbol));
+	HashCombine(seed, static_cast<std::size_t>(node.generic));
+	HashCombine(seed, node.number.Numerator().Hash());
+	HashCombine(seed, node.number.Denominator().Hash());
+	HashCombine(seed, std::hash<float>()(node.value));
+
+	// Children are already interned, so their addresses identify them
+	for (const Node* child : node.children)
+		HashCombine(seed, std::hash<const Node*>()(child));
+
+	return seed;
+}
+
+bool NodeEqual::operator()(const Node* node_a, const Node* node_b) const
+{
+	if (node_a->hash != node_b->hash)
+		return false;
+
+	return node_a->type == node_b->type &&
+	       node_a->generic == node_b->generic &&
+	       node_a->number == node_b->number &&
+	       node_a->value == node_b->value &&
+	       node_a->symbol == node_b->symbol &&
+	       node_a->children == node_b->children;
+}
+
+const Node* Store::Make(Node node)
+{
+	node.hash = HashNode(node);
+
+	auto found = m_table.find(&node);
+
+	if (found != m_table.end())
+		return *found;
+
+	m_nodes.push_back(std::move(node));
+	const Node* interned = &m_nodes.back();
+	m_table.insert(interned);
+
+	return interned;
+}
+
+const Node* Store::Intern(const std::unique_ptr<Expr>& expr)
+{
+	if (!expr)
+		return nullptr;
+
+	Node node;
+	node.type = expr->ExpressionType();
+	if (expr->IsVar())
+		node.symbol = expr->Symbol();
+	else if (expr->IsInteger() || expr->IsFraction())
+		node.number = expr->rValue();
+	else if (expr->IsFloat())
+		node.value = expr->fValue();
+	else if (expr->IsFunc())
+	{
+		node.symbol = expr->RespectTo();
+		node.children.push_back(Intern(expr->Param()));
+
+		if (expr->IsLog())
+			node.children.push_back(Intern(expr->Base()));
+	}
+	else if (expr->IsGeneric())
+	{
+		node.generic = true;
+
+		for (int i = 0; i < expr->ChildrenSize(); i++)
+			node.children.push_back(Intern(expr->ChildAt(i)));
+	}
+	else if (!expr->IsTerminal())
+	{
+		node.children.push_back(Intern(expr->Left()));
+		node.children.push_back(Intern(expr->Right()));
+	}
+
+	return Make(std::move(node));
+}
+
+std::unique_ptr<Expr> Store::Build(const Node* node) const
+{
+	if (!node)
+		return nullptr;
+
+	switch (node->type)
+	{
+	case ExprType::INTEGER:
+		return std::make_unique<Integer>(node->number.Numerator());
+	case ExprType::FLOAT:
+		return std::make_unique<Float>(node->value);
+	case ExprType::FRACTION:
+		return std::make_unique<Fraction>(node->number);
+	case ExprType::VARIABLE:
+		return std::make_unique<Var>(node->symbol);
+	case ExprType::PI:
+		return std::make_unique<Pi>();
+	case ExprType::e:
+		return std::make_unique<E>();
+	case ExprType::POW:
+		return std::make_unique<Pow>(Build(node->children[0]), Build(node->children[1]));
+	case ExprType::MUL:
+	case ExprType::ADD:
+	{
+		std::unique_ptr<Expr> expr;
+
+		if (!node->generic)
+		{
+			if (node->type == ExprType::MUL)
+				return std::make_unique<Mul>(Build(node->children[0]), Build(node->children[1]));
+
+			return std::make_unique<Add>(Build(node->children[0]), Build(node->children[1]));
+		}
+
+		if (node->type == ExprType::MUL)
+			expr = std::make_unique<Mul>();
+		else
+			expr = std::make_unique<Add>();
+
+		for (const Node* child : node->children)
+			expr->AddChild(Build(child));
+
+		return expr;
+	}
+	case ExprType::FAC:
+		return std::make_unique<Fac>(Build(node->children[0]));
+	case ExprType::LOG:
+		return std::make_unique<Log>(Build(node->children[0]), Build(node->children[1]));
+	case ExprType::LN:
+		return std::make_unique<Ln>(Build(node->children[0]));
+	case ExprType::SIN:
+		return std::make_unique<Sin>(Build(node->children[0]));
+	case ExprType::COS:
+		return std::make_unique<Cos>(Build(node->children[0]));
+	case ExprType::TAN:
+		return std::make_unique<Tan>(Build(node->children[0]));
+	case ExprType::DERIVATIVE:
+		return std::make_unique<Derivative>(Build(node->children[0]), node->symbol);
+	case ExprType::INTEGRAL:
+		return std::make_unique<Integral>(Build(node->children[0]), node->symbol);
+	default:
+		break;
+	}
+
+	return nullptr;
+}
+
+void Store::Clear()
+{
+	m_table.clear();
+	m_nodes.clear();
+}
+
+} // namespace dag
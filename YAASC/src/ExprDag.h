@@ -0,0 +1,63 @@
+#pragma once
+
+#include <deque>
+#include <unordered_set>
+
+#include "Expr.h"
+
+namespace dag {
+
+/* Immutable, hash-consed expression node. Structurally equal subexpressions
+*  are interned into one shared node, so within a store copying is a pointer
+*  copy and two expressions are equal exactly when their nodes are the same object:
+*
+*      +                 +
+*     / \               / \
+*    ^   ^     -->      \ /
+*   / \ / \              ^
+*  a  2 a  2            / \
+*                      a   2
+*
+*  The rewrite passes still own their trees through std::unique_ptr<Expr>, where
+*  operator== compares hashes and then walks, and tree_util::Clone copies. Only
+*  memo::Table keeps its keys and results here.
+*/
+struct Node
+{
+	ExprType type{ ExprType::NIL };
+	symbol::Id symbol{ symbol::none }; // Variable, or variable of a derivative or an integral
+	bool generic{ false };
+	Rational number;                   // Integer or fraction
+	float value{ 0.0f };
+	std::vector<const Node*> children; // Binary: left, right. Function: param, base. Generic: children
+	std::size_t hash{ 0 };
+};
+
+struct NodeHash
+{
+	std::size_t operator()(const Node* node) const { return node->hash; }
+};
+
+struct NodeEqual
+{
+	bool operator()(const Node* node_a, const Node* node_b) const;
+};
+
+class Store
+{
+private:
+	std::deque<Node> m_nodes; // Deque keeps node addresses stable while the store grows
+	std::unordered_set<const Node*, NodeHash, NodeEqual> m_table;
+
+	const Node* Make(Node node);
+
+public:
+	const Node* Intern(const std::unique_ptr<Expr>& expr);
+
+	std::unique_ptr<Expr> Build(const Node* node) const;
+
+	int Size() const { return (int)m_nodes.size(); }
+	void Clear();
+};
+
+} // namespace dag
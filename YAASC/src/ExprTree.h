@@ -1,9 +1,14 @@
 #pragma once
 
-#include <regex>
+#include <ostream>
 
 #include "Expr.h"
+#include "FlatTree.h"
 #include "Scanner.h"
+#include "Parser.h"
+#include "Printer.h"
+#include "Archive.h"
+#include "NodeArena.h"
 
 namespace yaasc
 {
@@ -11,29 +16,26 @@ namespace yaasc
 class ExprTree
 {
 private:
+	NodeArena m_arena; // Declared before the root, so that the nodes are destroyed before their memory
 	std::unique_ptr<Expr> m_root;
 
 public:
-	ExprTree(std::string input)
-		: m_root(std::move(Construct(input)))
+	ExprTree() {}
+	ExprTree(std::string_view input)
+		: m_root(Construct(input))
 	{
 	}
 
-	std::unique_ptr<Expr> Construct(std::string input);
+	std::unique_ptr<Expr> Construct(std::string_view input);
 	std::unique_ptr<Expr>& Root() { return m_root; }
+	NodeArena& Arena() { return m_arena; }
+
+	std::string TreeString(std::size_t line_width = 0);
+	void Write(std::ostream& out, std::size_t line_width = 0); // Streams the tree without building a string
+
+	bool Load(const std::string& path); // Replaces the root with an expression saved by Save()
+	bool Save(const std::string& path) const { return m_root && archive::Save(m_root, path); }
 
-	std::string FuncName(std::string input, int& index);
-	std::string TreeString();
-
-	void HandleVariableInput(std::string input, int& index, std::stack<std::unique_ptr<Expr>>& expr_stack);
-	void HandleDigitInput(std::string input, int& index, std::stack<std::unique_ptr<Expr>>& expr_stack);
-	void HandleFunctionInput(std::string input, int& index, std::stack<std::unique_ptr<Expr>>& expr_stack);
-	void UpdateFunctionStack(std::string input, int& index, std::stack<std::unique_ptr<Expr>>& expr_stack);
-	void AddFunctionToStack(std::string func_name, std::unique_ptr<Expr>& expr, std::stack<std::unique_ptr<Expr>>& expr_stack);
-	void TurnToNegative(std::unique_ptr<Expr>& expr);
-	void AddParenthesisToString(const std::unique_ptr<Expr>& expr, const std::unique_ptr<Expr>& child, std::string& input, bool left_parenthesis);
-	void RootToString(const std::unique_ptr<Expr>& expr, std::string& input);
-	void UpdateStack(std::stack<std::unique_ptr<Expr>>& expr_stack, ExprType type);
 	void ReplaceRoot(std::unique_ptr<Expr> new_root) { m_root = std::move(new_root); }
 
 	void PrintAssociative(const std::unique_ptr<Expr>& expr);
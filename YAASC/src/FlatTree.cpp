@@ -0,0 +1,434 @@
+#include "FlatTree.h"
+
+namespace flat {
+
+static std::string KindName(ExprType type)
+{
+	switch (type)
+	{
+	case ExprType::MUL:        return "*";
+	case ExprType::ADD:        return "+";
+	case ExprType::POW:        return "^";
+	case ExprType::FAC:        return "!";
+	case ExprType::LOG:        return "log";
+	case ExprType::LN:         return "ln";
+	case ExprType::SIN:        return "sin";
+	case ExprType::COS:        return "cos";
+	case ExprType::TAN:        return "tan";
+	case ExprType::DERIVATIVE: return "D";
+	case ExprType::INTEGRAL:   return "I";
+	default:
+		break;
+	}
+
+	return "";
+}
+
+Tree::Tree(const std::unique_ptr<Expr>& expr)
+{
+	if (expr)
+		BuildFrom(expr);
+}
+
+// Node hashes are computed the same way as Expr::Hash(), so both forms of an expression hash alike
+Index Tree::Push(ExprType type, int payload, std::size_t value_hash)
+{
+	Index i = Size();
+
+	m_kinds.push_back(type);
+	m_generic.push_back(0);
+	m_payloads.push_back(payload);
+	m_first_child.push_back((int)m_children.size());
+	m_child_count.push_back(0);
+	m_sizes.push_back(1);
+	m_hashes.push_back(value_hash);
+	m_pending.push_back(i);
+
+	return i;
+}
+
+Index Tree::AddInteger(BigInt value)
+{
+	std::size_t value_hash = value.Hash();
+	m_integers.push_back(std::move(value));
+
+	return Push(ExprType::INTEGER, (int)m_integers.size() - 1, value_hash);
+}
+
+Index Tree::AddFloat(float value)
+{
+	m_floats.push_back(value);
+	return Push(ExprType::FLOAT, (int)m_floats.size() - 1, Float::HashValue(value));
+}
+
+Index Tree::AddFraction(Rational value)
+{
+	std::size_t value_hash = std::hash<std::string>()(value.ToString());
+	m_fractions.push_back(std::move(value));
+
+	return Push(ExprType::FRACTION, (int)m_fractions.size() - 1, value_hash);
+}
+
+Index Tree::AddSymbol(ExprType type, symbol::Id id)
+{
+	return Push(type, id, std::hash<symbol::Id>()(id));
+}
+
+Index Tree::AddNode(ExprType type, int child_count, bool generic, symbol::Id respect_to)
+{
+	int first_pending = (int)m_pending.size() - child_count;
+	int first_child = (int)m_children.size();
+	int size = 1;
+	std::size_t seed = std::hash<std::string>()(KindName(type));
+
+	if (respect_to != symbol::none)
+		HashCombine(seed, std::hash<symbol::Id>()(respect_to));
+
+	if (generic)
+		HashCombine(seed, 1);
+
+	for (int k = first_pending; k < (int)m_pending.size(); k++)
+	{
+		Index child = m_pending[k];
+		m_children.push_back(child);
+		size += m_sizes[child];
+		HashCombine(seed, m_hashes[child]);
+	}
+
+	m_pending.resize(first_pending);
+
+	Index i = Push(type, respect_to, seed);
+	m_generic[i] = generic;
+	m_first_child[i] = first_child;
+	m_child_count[i] = child_count;
+	m_sizes[i] = size;
+
+	return i;
+}
+
+void Tree::BuildFrom(const std::unique_ptr<Expr>& expr)
+{
+	switch (expr->ExpressionType())
+	{
+	case ExprType::INTEGER:
+		AddInteger(expr->bValue());
+		return;
+	case ExprType::FLOAT:
+		AddFloat(expr->fValue());
+		return;
+	case ExprType::FRACTION:
+		AddFraction(expr->rValue());
+		return;
+	case ExprType::VARIABLE:
+	case ExprType::PI:
+	case ExprType::e:
+		AddSymbol(expr->ExpressionType(), expr->Symbol());
+		return;
+	default:
+		break;
+	}
+
+	int child_count = 0;
+
+	if (expr->IsFunc())
+	{
+		BuildFrom(expr->Param());
+		child_count++;
+
+		if (expr->IsLog())
+		{
+			BuildFrom(expr->Base());
+			child_count++;
+		}
+	}
+	else if (expr->IsGeneric())
+	{
+		for (int k = 0; k < expr->ChildrenSize(); k++)
+			BuildFrom(expr->ChildAt(k));
+
+		child_count = expr->ChildrenSize();
+	}
+	else if (expr->HasChildren())
+	{
+		BuildFrom(expr->Left());
+		BuildFrom(expr->Right());
+		child_count = 2;
+	}
+
+	AddNode(expr->ExpressionType(), child_count, expr->IsGeneric(), expr->RespectTo());
+}
+
+std::unique_ptr<Expr> Tree::ToExpr(Index i) const
+{
+	switch (Kind(i))
+	{
+	case ExprType::INTEGER:
+		return std::make_unique<Integer>(bValue(i));
+	case ExprType::FLOAT:
+		return std::make_unique<Float>(fValue(i));
+	case ExprType::FRACTION:
+		return std::make_unique<Fraction>(rValue(i));
+	case ExprType::VARIABLE:
+		return std::make_unique<Var>(Symbol(i));
+	case ExprType::PI:
+		return std::make_unique<Pi>();
+	case ExprType::e:
+		return std::make_unique<E>();
+	case ExprType::MUL:
+	case ExprType::ADD:
+	{
+		std::unique_ptr<Expr> expr;
+
+		if (Kind(i) == ExprType::MUL)
+			expr = std::make_unique<Mul>();
+		else
+			expr = std::make_unique<Add>();
+
+		if (IsGeneric(i))
+		{
+			for (int k = 0; k < ChildrenSize(i); k++)
+				expr->AddChild(ToExpr(ChildAt(i, k)));
+		}
+		else if (ChildrenSize(i) == 2)
+		{
+			expr->SetLeft(ToExpr(ChildAt(i, 0)));
+			expr->SetRight(ToExpr(ChildAt(i, 1)));
+		}
+
+		return expr;
+	}
+	case ExprType::POW:
+		return std::make_unique<Pow>(ToExpr(ChildAt(i, 0)), ToExpr(ChildAt(i, 1)));
+	case ExprType::FAC:
+		return std::make_unique<Fac>(ToExpr(ChildAt(i, 0)));
+	case ExprType::LOG:
+		return std::make_unique<Log>(ToExpr(ChildAt(i, 0)), ToExpr(ChildAt(i, 1)));
+	case ExprType::LN:
+		return std::make_unique<Ln>(ToExpr(ChildAt(i, 0)));
+	case ExprType::SIN:
+		return std::make_unique<Sin>(ToExpr(ChildAt(i, 0)));
+	case ExprType::COS:
+		return std::make_unique<Cos>(ToExpr(ChildAt(i, 0)));
+	case ExprType::TAN:
+		return std::make_unique<Tan>(ToExpr(ChildAt(i, 0)));
+	case ExprType::DERIVATIVE:
+		return std::make_unique<Derivative>(ToExpr(ChildAt(i, 0)), Symbol(i));
+	case ExprType::INTEGRAL:
+		return std::make_unique<Integral>(ToExpr(ChildAt(i, 0)), Symbol(i));
+	default:
+		break;
+	}
+
+	return nullptr;
+}
+
+void Tree::Clear()
+{
+	m_kinds.clear();
+	m_generic.clear();
+	m_payloads.clear();
+	m_first_child.clear();
+	m_child_count.clear();
+	m_sizes.clear();
+	m_hashes.clear();
+	m_children.clear();
+	m_integers.clear();
+	m_floats.clear();
+	m_fractions.clear();
+	m_pending.clear();
+}
+
+// Compares the nodes only, not their children
+bool Tree::SameNode(Index i, const Tree& other, Index j) const
+{
+	if (Kind(i) != other.Kind(j))
+	{
+		// Float 2 and integer 2 are the same number
+		if (kind::Traits(Kind(i)) & kind::Traits(other.Kind(j)) & kind::number)
+			return Name(i) == other.Name(j);
+
+		return false;
+	}
+
+	if (IsGeneric(i) != other.IsGeneric(j) || ChildrenSize(i) != other.ChildrenSize(j))
+		return false;
+
+	switch (Kind(i))
+	{
+	case ExprType::INTEGER:
+		return bValue(i) == other.bValue(j);
+	case ExprType::FLOAT:
+		return Name(i) == other.Name(j);
+	case ExprType::FRACTION:
+		return rValue(i) == other.rValue(j);
+	case ExprType::VARIABLE:
+	case ExprType::DERIVATIVE:
+	case ExprType::INTEGRAL:
+		return Symbol(i) == other.Symbol(j);
+	default:
+		break;
+	}
+
+	return true;
+}
+
+bool Tree::IsNegOne(Index i) const
+{
+	if (Kind(i) == ExprType::INTEGER)
+		return bValue(i) == -1;
+	else if (Kind(i) == ExprType::FLOAT)
+		return Float::Format(fValue(i)) == "-1";
+
+	return false;
+}
+
+std::string Tree::Name(Index i) const
+{
+	switch (Kind(i))
+	{
+	case ExprType::INTEGER:
+		return bValue(i).ToString();
+	case ExprType::FLOAT:
+		return Float::Format(fValue(i));
+	case ExprType::FRACTION:
+		return rValue(i).ToString();
+	case ExprType::VARIABLE:
+	case ExprType::PI:
+	case ExprType::e:
+		return symbol::Name(Symbol(i));
+	default:
+		break;
+	}
+
+	return KindName(Kind(i));
+}
+
+// In post-order two subtrees are equal exactly when their nodes are equal one by one
+bool Equal(const Tree& tree_a, Index a, const Tree& tree_b, Index b)
+{
+	if (tree_a.SubtreeSize(a) != tree_b.SubtreeSize(b))
+		return false;
+
+	Index begin_a = tree_a.SubtreeBegin(a);
+	Index begin_b = tree_b.SubtreeBegin(b);
+
+	for (int k = 0; k < tree_a.SubtreeSize(a); k++)
+	{
+		if (!tree_a.SameNode(begin_a + k, tree_b, begin_b + k))
+			return false;
+	}
+
+	return true;
+}
+
+Index LeftmostChild(const Tree& tree, Index i)
+{
+	while (tree.ChildrenSize(i) != 0 && !(kind::Traits(tree.Kind(i)) & kind::function))
+		i = tree.ChildAt(i, 0);
+
+	return i;
+}
+
+bool IsConstant(const Tree& tree, Index i, symbol::Id respect_to)
+{
+	for (Index k = tree.SubtreeBegin(i); k <= i; k++)
+	{
+		if (tree.Kind(k) == ExprType::VARIABLE && tree.Symbol(k) == respect_to)
+			return false;
+	}
+
+	return true;
+}
+
+static void AddParenthesis(const Tree& tree, Index parent, Index child, std::string& output, bool left_parenthesis)
+{
+	ExprType child_type = tree.Kind(child);
+	bool can_add_parenthesis = false;
+
+	if (tree.Kind(parent) == ExprType::POW &&
+	   (child_type == ExprType::ADD || child_type == ExprType::MUL || kind::Traits(child_type) & kind::function))
+		can_add_parenthesis = true;
+	else if (tree.Kind(parent) == ExprType::MUL && child_type == ExprType::ADD)
+		can_add_parenthesis = true;
+
+	if (can_add_parenthesis)
+		output += left_parenthesis ? '(' : ')';
+}
+
+void ToString(const Tree& tree, Index i, std::string& output)
+{
+	ExprType type = tree.Kind(i);
+	bool is_binary = !tree.IsGeneric(i) && !(kind::Traits(type) & kind::function) && tree.ChildrenSize(i) == 2;
+
+	if (is_binary)
+	{
+		Index left = tree.ChildAt(i, 0);
+
+		if (type == ExprType::MUL && tree.IsNegOne(left))
+			output += '-';
+		else
+		{
+			AddParenthesis(tree, i, left, output, true);
+			ToString(tree, left, output);
+			AddParenthesis(tree, i, left, output, false);
+		}
+	}
+
+	if (tree.IsGeneric(i))
+	{
+		int size = tree.ChildrenSize(i);
+
+		for (int k = 0; k < size; k++)
+		{
+			Index child = tree.ChildAt(i, k);
+			AddParenthesis(tree, i, child, output, true);
+
+			if (type == ExprType::MUL && tree.IsNegOne(child))
+				output += '-';
+			else
+			{
+				ToString(tree, child, output);
+
+				if (k + 1 < size && type == ExprType::ADD)
+					output += '+';
+			}
+
+			AddParenthesis(tree, i, child, output, false);
+		}
+	}
+	else if (kind::Traits(type) & kind::function)
+	{
+		if (type != ExprType::FAC)
+			output += tree.Name(i);
+
+		output += '(';
+		ToString(tree, tree.ChildAt(i, 0), output);
+		output += ')';
+
+		if (type == ExprType::FAC)
+			output += tree.Name(i);
+	}
+	else if (type != ExprType::MUL)
+		output += tree.Name(i);
+
+	if (is_binary)
+	{
+		Index right = tree.ChildAt(i, 1);
+
+		AddParenthesis(tree, i, right, output, true);
+		ToString(tree, right, output);
+		AddParenthesis(tree, i, right, output, false);
+	}
+}
+
+std::string ToString(const Tree& tree)
+{
+	std::string output = "";
+
+	if (!tree.Empty())
+		ToString(tree, tree.Root(), output);
+
+	return output;
+}
+
+} // namespace flat
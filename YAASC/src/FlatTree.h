@@ -0,0 +1,93 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "Expr.h"
+
+namespace flat {
+
+using Index = int;
+
+constexpr Index none = -1;
+
+/* Read-only copy of an expression tree stored in post-order in flat arrays.
+*  Children come before their parent, so every subtree is one contiguous
+*  range of indices and the root is the last node:
+*
+*        +            index: 0  1  2  3  4
+*       / \           kind:  a  b  *  c  +
+*      *   c          children of 2: 0, 1
+*     / \             children of 4: 2, 3
+*    a   b            subtree of 2: [0, 2]
+*
+*  Numbers are stored in their own pools and variables by their symbol id, so
+*  equality, hashing, printing and searching are linear scans over a few arrays.
+*/
+class Tree
+{
+private:
+	std::vector<ExprType> m_kinds;
+	std::vector<std::uint8_t> m_generic;
+	std::vector<int> m_payloads;      // Index to a number pool, or symbol id of a variable or derivative
+	std::vector<int> m_first_child;   // Children of node i: m_children[m_first_child[i] .. + m_child_count[i]]
+	std::vector<int> m_child_count;
+	std::vector<int> m_sizes;         // Subtree of node i: [i - m_sizes[i] + 1, i]
+	std::vector<std::size_t> m_hashes;
+	std::vector<Index> m_children;
+
+	std::vector<BigInt> m_integers;
+	std::vector<float> m_floats;
+	std::vector<Rational> m_fractions;
+
+	std::vector<Index> m_pending;     // Roots of the subtrees that don't have a parent yet
+
+	Index Push(ExprType type, int payload, std::size_t value_hash);
+	void BuildFrom(const std::unique_ptr<Expr>& expr);
+
+public:
+	Tree() {}
+	Tree(const std::unique_ptr<Expr>& expr);
+
+	// Post-order building: every node takes the latest child_count subtrees as its children
+	Index AddInteger(BigInt value);
+	Index AddFloat(float value);
+	Index AddFraction(Rational value);
+	Index AddSymbol(ExprType type, symbol::Id id);
+	Index AddNode(ExprType type, int child_count, bool generic = false, symbol::Id respect_to = symbol::none);
+
+	std::unique_ptr<Expr> ToExpr(Index i) const;
+	std::unique_ptr<Expr> ToExpr() const { return Empty() ? nullptr : ToExpr(Root()); }
+
+	int Size() const { return (int)m_kinds.size(); }
+	bool Empty() const { return m_kinds.empty(); }
+	Index Root() const { return Size() - 1; }
+	void Clear();
+
+	ExprType Kind(Index i) const { return m_kinds[i]; }
+	bool IsGeneric(Index i) const { return m_generic[i] != 0; }
+	int ChildrenSize(Index i) const { return m_child_count[i]; }
+	Index ChildAt(Index i, int k) const { return m_children[m_first_child[i] + k]; }
+	Index SubtreeBegin(Index i) const { return i - m_sizes[i] + 1; }
+	int SubtreeSize(Index i) const { return m_sizes[i]; }
+	std::size_t Hash(Index i) const { return m_hashes[i]; }
+
+	const BigInt& bValue(Index i) const { return m_integers[m_payloads[i]]; }
+	const Rational& rValue(Index i) const { return m_fractions[m_payloads[i]]; }
+	float fValue(Index i) const { return m_floats[m_payloads[i]]; }
+	symbol::Id Symbol(Index i) const { return m_payloads[i]; }
+
+	bool SameNode(Index i, const Tree& other, Index j) const;
+	bool IsNegOne(Index i) const;
+	std::string Name(Index i) const;
+};
+
+bool Equal(const Tree& tree_a, Index a, const Tree& tree_b, Index b);
+Index LeftmostChild(const Tree& tree, Index i);
+bool IsConstant(const Tree& tree, Index i, symbol::Id respect_to);
+
+std::string ToString(const Tree& tree);
+void ToString(const Tree& tree, Index i, std::string& output);
+
+} // namespace flat
@@ -15,7 +15,7 @@ void ApplyLogarithmRules(std::unique_ptr<Expr>& expr)
 // log(ab) --> log(a) + log(b)
 void LogarithmProduct(std::unique_ptr<Expr>& expr)
 {
-	if (expr->IsTerminal())
+	if (expr->IsTerminal() || expr->Settled())
 		return;
 
 	if (expr->IsGeneric())
@@ -31,6 +31,12 @@ void LogarithmProduct(std::unique_ptr<Expr>& expr)
 			LogarithmProduct(expr->Right());
 	}
 
+	expr->Rehash();
+	LogarithmProductNode(expr);
+}
+
+void LogarithmProductNode(std::unique_ptr<Expr>& expr)
+{
 	if (!expr->IsLog())
 		return;
 
@@ -100,7 +106,7 @@ void LogarithmProductHelper(std::unique_ptr<Expr>& expr, bool generic)
 // log(a^n) --> nlog(a)
 void LogarithmPower(std::unique_ptr<Expr>& expr)
 {
-	if (expr->IsTerminal())
+	if (expr->IsTerminal() || expr->Settled())
 		return;
 
 	if (expr->IsGeneric())
@@ -116,6 +122,12 @@ void LogarithmPower(std::unique_ptr<Expr>& expr)
 			LogarithmPower(expr->Right());
 	}
 
+	expr->Rehash();
+	LogarithmPowerNode(expr);
+}
+
+void LogarithmPowerNode(std::unique_ptr<Expr>& expr)
+{
 	if (!expr->IsLog())
 		return;
 
@@ -148,7 +160,7 @@ void LogarithmPower(std::unique_ptr<Expr>& expr)
 // log(1) --> 0, loga(a) --> 1, loga(a^b) --> b, a^(loga(b)) --> b
 void SimplifySpecialLogarithm(std::unique_ptr<Expr>& expr)
 {
-	if (expr->IsTerminal())
+	if (expr->IsTerminal() || expr->Settled())
 		return;
 
 	if (expr->IsGeneric())
@@ -164,6 +176,12 @@ void SimplifySpecialLogarithm(std::unique_ptr<Expr>& expr)
 			SimplifySpecialLogarithm(expr->Right());
 	}
 
+	expr->Rehash();
+	SimplifySpecialLogarithmNode(expr);
+}
+
+void SimplifySpecialLogarithmNode(std::unique_ptr<Expr>& expr)
+{
 	// a^(loga(b)) --> b
 	if (RaisedToLog(expr))
 	{
@@ -178,12 +196,12 @@ void SimplifySpecialLogarithm(std::unique_ptr<Expr>& expr)
 	if (expr->Param()->IsOne())
 		expr = std::move(std::make_unique<Integer>(0));
 	// loga(a) = 1
-	else if (expr->Param() == expr->Base())
+	else if (SameOperand(expr->Param(), expr->Base()))
 		expr = std::move(std::make_unique<Integer>(1));
 	// loga(a^b) --> b
 	else if (expr->Param()->IsPow())
 	{
-		if (expr->Param()->Left() == expr->Base())
+		if (SameOperand(expr->Param()->Left(), expr->Base()))
 			expr = std::move(expr->Param()->Right());
 	}
 }
@@ -199,4 +217,19 @@ bool RaisedToLog(const std::unique_ptr<Expr>& expr)
 	return true;
 }
 
+// a and a^1 are the same operand, the base of ln is e^1 while log(a^n) --> nlog(a) leaves a bare
+bool SameOperand(const std::unique_ptr<Expr>& expr_a, const std::unique_ptr<Expr>& expr_b)
+{
+	if (expr_a == expr_b)
+		return true;
+
+	if (expr_a->IsPow() && expr_a->Right()->IsOne())
+		return expr_a->Left() == expr_b;
+
+	if (expr_b->IsPow() && expr_b->Right()->IsOne())
+		return expr_a == expr_b->Left();
+
+	return false;
+}
+
 }
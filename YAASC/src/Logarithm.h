@@ -7,10 +7,14 @@ namespace algebra {
 
 void ApplyLogarithmRules(std::unique_ptr<Expr>& expr);
 void LogarithmProduct(std::unique_ptr<Expr>& expr);
+void LogarithmProductNode(std::unique_ptr<Expr>& expr);
 void LogarithmProductHelper(std::unique_ptr<Expr>& expr, bool generic);
 void LogarithmPower(std::unique_ptr<Expr>& expr);
+void LogarithmPowerNode(std::unique_ptr<Expr>& expr);
 void SimplifySpecialLogarithm(std::unique_ptr<Expr>& expr);
+void SimplifySpecialLogarithmNode(std::unique_ptr<Expr>& expr);
 
 bool RaisedToLog(const std::unique_ptr<Expr>& expr);
+bool SameOperand(const std::unique_ptr<Expr>& expr_a, const std::unique_ptr<Expr>& expr_b);
 
 }
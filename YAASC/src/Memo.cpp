@@ -0,0 +1,54 @@
+#include "Memo.h"
+
+namespace memo {
+
+bool Table::Find(const dag::Node* key, std::unique_ptr<Expr>& expr)
+{
+	auto found = m_results.find(key);
+
+	if (found == m_results.end())
+	{
+		m_misses++;
+		return false;
+	}
+
+	m_hits++;
+
+	if (found->second != key)
+		expr = m_store.Build(found->second);
+
+	return true;
+}
+
+void Table::Insert(const dag::Node* key, const std::unique_ptr<Expr>& result)
+{
+	m_results[key] = m_store.Intern(result);
+}
+
+void Table::Trim()
+{
+	if (Bytes() > m_max_bytes)
+		Clear();
+}
+
+// Estimate: interned nodes with their child lists, and one bucket and entry per result
+std::size_t Table::Bytes() const
+{
+	std::size_t entry = sizeof(std::pair<const dag::Node*, const dag::Node*>) + 2 * sizeof(void*);
+
+	return m_store.Size() * (sizeof(dag::Node) + 2 * sizeof(void*)) + m_results.size() * entry;
+}
+
+void Table::Clear()
+{
+	m_results.clear();
+	m_store.Clear();
+}
+
+Table& Table::Session()
+{
+	static thread_local Table table;
+	return table;
+}
+
+} // namespace memo
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <unordered_map>
+
+#include "ExprDag.h"
+
+namespace memo {
+
+constexpr std::size_t default_max_bytes = 16 * 1024 * 1024;
+
+/* Rewritten forms of the subtrees seen while simplifying, so that a subterm that occurs
+*  many times is rewritten once and then copied:
+*
+*      key:    D(x^2)x^3 --> result: 2x^4
+*      key:    sin(x)    --> result: sin(x)  (nothing to rewrite)
+*
+*  Keys and results are interned in a dag::Store, so structurally equal subtrees are
+*  found by hash and compared node by node, and entries share their common parts. Keys
+*  must stay valid while a subtree is being rewritten, so the memory cap is enforced
+*  only by Trim(), which drops the whole table when it has grown past the cap.
+*/
+class Table
+{
+private:
+	dag::Store m_store;
+	std::unordered_map<const dag::Node*, const dag::Node*> m_results;
+	std::size_t m_max_bytes;
+
+	std::size_t m_hits{ 0 };
+	std::size_t m_misses{ 0 };
+
+public:
+	Table(std::size_t max_bytes = default_max_bytes) : m_max_bytes(max_bytes) {}
+
+	const dag::Node* Key(const std::unique_ptr<Expr>& expr) { return m_store.Intern(expr); }
+
+	// Replaces expr with the memoized result of key, if there is one
+	bool Find(const dag::Node* key, std::unique_ptr<Expr>& expr);
+	void Insert(const dag::Node* key, const std::unique_ptr<Expr>& result);
+
+	void SetMaxBytes(std::size_t max_bytes) { m_max_bytes = max_bytes; }
+	std::size_t MaxBytes() const { return m_max_bytes; }
+	std::size_t Bytes() const;
+
+	std::size_t Hits() const { return m_hits; }
+	std::size_t Misses() const { return m_misses; }
+	int Size() const { return (int)m_results.size(); }
+
+	void Trim();
+	void Clear();
+
+	static Table& Session(); // Table of the current thread, kept between expressions
+};
+
+} // namespace memo
@@ -0,0 +1,36 @@
+#include "NodeArena.h"
+
+thread_local NodeArena* NodeArena::s_current = nullptr;
+
+void* NodeArena::Allocate(std::size_t size)
+{
+	constexpr std::size_t alignment = alignof(std::max_align_t);
+	size = (size + alignment - 1) & ~(alignment - 1);
+
+	if (size > m_remaining)
+	{
+		std::size_t new_block_size = size > block_size ? size : block_size;
+		m_blocks.push_back(std::unique_ptr<char[]>(new char[new_block_size]));
+		m_cursor = m_blocks.back().get();
+		m_remaining = new_block_size;
+	}
+
+	void* memory = m_cursor;
+	m_cursor += size;
+	m_remaining -= size;
+
+	m_allocations++;
+	m_bytes += size;
+
+	return memory;
+}
+
+// Releases every node at once, nodes must not be used after this
+void NodeArena::Reset()
+{
+	m_blocks.clear();
+	m_cursor = nullptr;
+	m_remaining = 0;
+	m_allocations = 0;
+	m_bytes = 0;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/* Bump allocator for expression nodes. While a NodeArena::Scope is active on a thread,
+*  every Expr created on that thread is carved out of the arena. Deleting such a node only
+*  runs its destructor; the memory of all nodes is released at once with the arena.
+*/
+class NodeArena
+{
+private:
+	static constexpr std::size_t block_size = 64 * 1024;
+
+	std::vector<std::unique_ptr<char[]>> m_blocks;
+	char* m_cursor{ nullptr };
+	std::size_t m_remaining{ 0 };
+
+	std::size_t m_allocations{ 0 };
+	std::size_t m_bytes{ 0 };
+
+	static thread_local NodeArena* s_current;
+
+public:
+	class Scope
+	{
+	private:
+		NodeArena* m_previous;
+
+	public:
+		Scope(NodeArena& arena) : m_previous(s_current) { s_current = &arena; }
+		~Scope() { s_current = m_previous; }
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+	};
+
+	NodeArena() = default;
+	NodeArena(const NodeArena&) = delete;
+	NodeArena& operator=(const NodeArena&) = delete;
+
+	void* Allocate(std::size_t size);
+	void Reset();
+
+	std::size_t Allocations() const { return m_allocations; }
+	std::size_t Bytes() const { return m_bytes; }
+	std::size_t Blocks() const { return m_blocks.size(); }
+
+	static NodeArena* Current() { return s_current; }
+};
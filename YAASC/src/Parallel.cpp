@@ -0,0 +1,146 @@
+#include "Parallel.h"
+
+namespace parallel {
+
+thread_local bool ThreadPool::s_inside_task = false;
+
+ThreadPool::ThreadPool(int threads)
+{
+	for (int i = 1; i < threads; i++)
+		m_workers.emplace_back(&ThreadPool::Work, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+
+	m_wake.notify_all();
+
+	for (std::thread& worker : m_workers)
+		worker.join();
+}
+
+void ThreadPool::Work()
+{
+	unsigned seen = 0;
+
+	while (true)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_wake.wait(lock, [&] { return m_stop || m_loop != seen; });
+
+		if (m_stop)
+			return;
+
+		seen = m_loop;
+		lock.unlock();
+
+		RunChunks();
+
+		lock.lock();
+
+		if (--m_busy == 0)
+			m_done.notify_one();
+	}
+}
+
+void ThreadPool::RunChunks()
+{
+	s_inside_task = true;
+
+	for (int begin = m_next.fetch_add(m_chunk); begin < m_count; begin = m_next.fetch_add(m_chunk))
+	{
+		int end = begin + m_chunk < m_count ? begin + m_chunk : m_count;
+
+		for (int i = begin; i < end; i++)
+			(*m_task)(i);
+	}
+
+	s_inside_task = false;
+}
+
+void ThreadPool::ForEach(int count, const std::function<void(int)>& task)
+{
+	std::unique_lock<std::mutex> loop(m_loop_mutex, std::defer_lock);
+
+	if (m_workers.empty() || s_inside_task || !loop.try_lock())
+	{
+		for (int i = 0; i < count; i++)
+			task(i);
+
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_task = &task;
+		m_count = count;
+		m_chunk = count / (Threads() * chunks_per_thread);
+		m_chunk = m_chunk > 0 ? m_chunk : 1;
+		m_next = 0;
+		m_busy = static_cast<int>(m_workers.size());
+		m_loop++;
+	}
+
+	m_wake.notify_all();
+	RunChunks();
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_done.wait(lock, [&] { return m_busy == 0; });
+	m_task = nullptr;
+}
+
+static std::unique_ptr<ThreadPool>& SharedPool()
+{
+	static std::unique_ptr<ThreadPool> pool;
+	return pool;
+}
+
+ThreadPool& Pool()
+{
+	static std::once_flag created;
+	std::call_once(created, [] {
+		if (!SharedPool())
+			SharedPool() = std::make_unique<ThreadPool>(DefaultThreads());
+	});
+
+	return *SharedPool();
+}
+
+void SetThreads(int threads)
+{
+	Pool();
+	SharedPool() = std::make_unique<ThreadPool>(threads > 0 ? threads : DefaultThreads());
+}
+
+int DefaultThreads()
+{
+	unsigned threads = std::thread::hardware_concurrency();
+	return threads > 0 ? static_cast<int>(threads) : 1;
+}
+
+// Each child only touches its own subtree, so the result doesn't depend on the thread count
+void ForEachChild(std::unique_ptr<Expr>& root, const std::function<void(std::unique_ptr<Expr>&)>& task)
+{
+	int count = root->ChildrenSize();
+
+	if (count < min_parallel_children)
+	{
+		for (int i = 0; i < count; i++)
+			task(root->ChildAt(i));
+
+		return;
+	}
+
+	Expr::GenerationState state = Expr::CurrentGenerationState();
+
+	Pool().ForEach(count, [&](int i) {
+		Expr::SetGenerationState(state);
+		task(root->ChildAt(i));
+	});
+}
+
+} // namespace parallel
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+#include "Expr.h"
+
+namespace parallel {
+
+constexpr int min_parallel_children = 128; // Smaller nodes are processed by the calling thread
+constexpr int chunks_per_thread = 4;
+
+/* Fixed set of worker threads that help the calling thread with one loop at a time:
+*
+*      ForEach(10, task):  caller   claims [0, 3) [9, 10)
+*                          worker 1 claims [3, 6)
+*                          worker 2 claims [6, 9)
+*
+*  Indices are claimed in chunks from a shared counter, so a thread that finishes early
+*  takes over the rest of the loop. A loop started from inside a task, or while another
+*  thread's loop is running, is run by the calling thread alone.
+*/
+class ThreadPool
+{
+private:
+	std::vector<std::thread> m_workers;
+
+	std::mutex m_loop_mutex; // Held by the thread whose loop the pool is running
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_done;
+
+	const std::function<void(int)>* m_task{ nullptr };
+	int m_count{ 0 };
+	int m_chunk{ 1 };
+	std::atomic<int> m_next{ 0 };
+	int m_busy{ 0 }; // Workers that haven't finished the current loop
+	unsigned m_loop{ 0 };
+	bool m_stop{ false };
+
+	static thread_local bool s_inside_task;
+
+	void Work();
+	void RunChunks();
+
+public:
+	explicit ThreadPool(int threads);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	int Threads() const { return static_cast<int>(m_workers.size()) + 1; }
+
+	void ForEach(int count, const std::function<void(int)>& task);
+};
+
+ThreadPool& Pool();
+void SetThreads(int threads); // Must not be called while the pool is in use
+int DefaultThreads();
+
+// Applies task to each child of a generic node, in parallel when the node is large
+void ForEachChild(std::unique_ptr<Expr>& root, const std::function<void(std::unique_ptr<Expr>&)>& task);
+
+} // namespace parallel
@@ -0,0 +1,465 @@
+#include <cctype>
+#include <charconv>
+
+#include "Parser.h"
+
+namespace parser {
+
+static bool IsLetter(char c)
+{
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+static bool IsDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+static bool IsOperatorChar(char c)
+{
+	return c == '+' || c == '-' || c == '*' || c == '/' || c == '^' || c == '!';
+}
+
+static bool IsIgnored(char c)
+{
+	return !IsLetter(c) && !IsDigit(c) && !IsOperatorChar(c) && c != '(' && c != ')';
+}
+
+void Lexer::SkipIgnored()
+{
+	while (m_index < m_input.length() && IsIgnored(m_input[m_index]))
+		m_index++;
+}
+
+// Function names need an argument: sin(x) is a function, sin() is not
+bool Lexer::HasArgument(std::size_t index) const
+{
+	while (index < m_input.length() && IsIgnored(m_input[index]))
+		index++;
+
+	if (index >= m_input.length() || m_input[index] != '(')
+		return false;
+
+	index++;
+
+	while (index < m_input.length() && IsIgnored(m_input[index]))
+		index++;
+
+	return index < m_input.length() && m_input[index] != ')';
+}
+
+void Lexer::Scan()
+{
+	SkipIgnored();
+
+	if (m_index >= m_input.length())
+	{
+		m_token = { TokenType::END, {} };
+		return;
+	}
+
+	std::size_t start = m_index;
+	char c = m_input[m_index];
+
+	if (IsDigit(c))
+	{
+		while (m_index < m_input.length() && IsDigit(m_input[m_index]))
+			m_index++;
+
+		if (m_index < m_input.length() && m_input[m_index] == '.')
+		{
+			m_index++;
+
+			while (m_index < m_input.length() && IsDigit(m_input[m_index]))
+				m_index++;
+		}
+
+		m_token = { TokenType::NUMBER, m_input.substr(start, m_index - start) };
+	}
+	else if (IsLetter(c))
+	{
+		if (m_index >= m_word_end)
+		{
+			m_word_end = m_index;
+
+			while (m_word_end < m_input.length() && (IsLetter(m_input[m_word_end]) || IsDigit(m_input[m_word_end])))
+				m_word_end++;
+		}
+
+		// The earliest start of a name wins, like in scanner::AddFunctionToken(): xlog2(y) --> x log2(y)
+		std::string_view rest = m_input.substr(m_index, m_word_end - m_index);
+
+		if (IsFunctionName(rest) && HasArgument(m_word_end))
+		{
+			m_index = m_word_end;
+			m_token = { TokenType::FUNCTION, rest };
+		}
+		else if (c == 'p' && rest.length() > 1 && rest[1] == 'i')
+		{
+			m_index += 2;
+			m_token = { TokenType::PI, rest.substr(0, 2) };
+		}
+		else
+		{
+			m_index++;
+			m_token = { TokenType::VARIABLE, rest.substr(0, 1) };
+		}
+	}
+	else if (IsOperatorChar(c))
+	{
+		m_index++;
+		m_token = { TokenType::OPERATOR, m_input.substr(start, 1) };
+
+		while (true)
+		{
+			SkipIgnored();
+
+			if (m_index >= m_input.length() || m_input[m_index] != c)
+				break;
+
+			m_index++;
+		}
+	}
+	else
+	{
+		m_index++;
+		m_token = { c == '(' ? TokenType::LEFT_PARENTHESIS : TokenType::RIGHT_PARENTHESIS, m_input.substr(start, 1) };
+	}
+}
+
+std::unique_ptr<Expr> Parser::Expression(int min_power)
+{
+	std::unique_ptr<Expr> left = Prefix();
+	bool open_chain = false; // Left is a sum or a product that still takes operands
+
+	while (left)
+	{
+		const Token& token = m_lexer.Peek();
+		char op = '*'; // Implicit multiplication
+
+		if (token.type == TokenType::OPERATOR)
+			op = token.text[0];
+		else if (!StartsOperand(token))
+			break;
+
+		int power = BindingPower(op);
+
+		if (power < min_power)
+			break;
+
+		if (token.type == TokenType::OPERATOR)
+			m_lexer.Next();
+
+		if (op == '!' || op == '^')
+		{
+			if (open_chain)
+				CloseChain(left);
+
+			open_chain = false;
+
+			if (op == '!')
+				left = std::make_unique<Fac>(std::move(left));
+			else
+			{
+				std::unique_ptr<Expr> right = Expression(power + 1);
+
+				if (!right)
+					return nullptr;
+
+				left = std::make_unique<Pow>(std::move(left), std::move(right));
+			}
+
+			continue;
+		}
+
+		std::unique_ptr<Expr> right = Expression(power + 1);
+
+		if (!right)
+			return nullptr;
+
+		// Integer division is a fraction right away: 1/2 --> 1/2, but 2x/3 --> 2x3^-1
+		if (op == '/' && !open_chain && left->IsInteger() && right->IsInteger())
+		{
+			left = Divide(std::move(left), std::move(right));
+			continue;
+		}
+
+		ExprType type = op == '+' || op == '-' ? ExprType::ADD : ExprType::MUL;
+
+		if (open_chain && left->ExpressionType() != type)
+		{
+			CloseChain(left);
+			open_chain = false;
+		}
+
+		if (!open_chain)
+		{
+			left = OpenChain(type, std::move(left));
+			open_chain = true;
+		}
+
+		AppendOperand(left, Operand(op, std::move(right)));
+	}
+
+	if (left && open_chain)
+		CloseChain(left);
+
+	return left;
+}
+
+std::unique_ptr<Expr> Parser::Prefix()
+{
+	Token token = m_lexer.Peek();
+
+	switch (token.type)
+	{
+	case TokenType::NUMBER:
+		m_lexer.Next();
+		return Number(token.text);
+	case TokenType::VARIABLE:
+		m_lexer.Next();
+		return Variable(token.text[0]);
+	case TokenType::PI:
+		m_lexer.Next();
+		return std::make_unique<Pow>(std::make_unique<Pi>(), std::make_unique<Integer>(1));
+	case TokenType::FUNCTION:
+		m_lexer.Next();
+		return Function(token.text);
+	case TokenType::LEFT_PARENTHESIS:
+		return Parenthesized();
+	case TokenType::OPERATOR:
+		if (token.text[0] == '-' || token.text[0] == '+')
+		{
+			m_lexer.Next();
+			std::unique_ptr<Expr> operand = Expression(unary_power);
+
+			if (!operand || token.text[0] == '+')
+				return operand;
+
+			return Negate(std::move(operand));
+		}
+		return nullptr;
+	default:
+		return nullptr;
+	}
+}
+
+std::unique_ptr<Expr> Parser::Function(std::string_view name)
+{
+	std::unique_ptr<Expr> param = Parenthesized();
+
+	if (!param)
+		return nullptr;
+
+	if (name == "log" || name == "log10")
+		return std::make_unique<Log>(std::move(param), std::make_unique<Integer>(10));
+	else if (name == "log2")
+		return std::make_unique<Log>(std::move(param), std::make_unique<Integer>(2));
+	else if (name == "ln")
+		return std::make_unique<Ln>(std::move(param));
+	else if (name == "sin")
+		return std::make_unique<Sin>(std::move(param));
+	else if (name == "cos")
+		return std::make_unique<Cos>(std::move(param));
+	else if (name == "tan")
+		return std::make_unique<Tan>(std::move(param));
+	else if (name == "D")
+		return std::make_unique<Derivative>(std::move(param), "x"); // FIXME: Can be respect to any variable
+	else
+		return std::make_unique<Integral>(std::move(param), "x"); // FIXME: Can be respect to any variable
+}
+
+std::unique_ptr<Expr> Parser::Parenthesized()
+{
+	if (!Expect(TokenType::LEFT_PARENTHESIS))
+		return nullptr;
+
+	std::unique_ptr<Expr> expr = Expression(0);
+
+	if (!expr || !Expect(TokenType::RIGHT_PARENTHESIS))
+		return nullptr;
+
+	return expr;
+}
+
+bool Parser::Expect(TokenType type)
+{
+	if (m_lexer.Peek().type != type)
+		return false;
+
+	m_lexer.Next();
+
+	return true;
+}
+
+std::unique_ptr<Expr> Parse(std::string_view input)
+{
+	Parser parser(input);
+	std::unique_ptr<Expr> expr = parser.Expression(0);
+
+	if (!parser.AtEnd())
+		return nullptr;
+
+	return expr;
+}
+
+std::unique_ptr<Expr> Number(std::string_view digits)
+{
+	const char* first = digits.data();
+	const char* last = first + digits.length();
+
+	if (digits.find('.') != std::string_view::npos)
+	{
+		float value = 0.0f;
+		std::from_chars(first, last, value);
+
+		return std::make_unique<Float>(value);
+	}
+
+	long long value = 0;
+
+	if (std::from_chars(first, last, value).ec == std::errc())
+		return std::make_unique<Integer>(BigInt(value));
+
+	return std::make_unique<Integer>(BigInt::FromString(std::string(digits)));
+}
+
+std::unique_ptr<Expr> Variable(char name)
+{
+	std::unique_ptr<Expr> expr;
+
+	if (name == 'e')
+		expr = std::make_unique<E>();
+	else
+		expr = std::make_unique<Var>(std::string(1, name));
+
+	return std::make_unique<Pow>(std::move(expr), std::make_unique<Integer>(1));
+}
+
+std::unique_ptr<Expr> Negate(std::unique_ptr<Expr> expr)
+{
+	if (expr->IsInteger())
+		return std::make_unique<Integer>(-expr->bValue());
+	else if (expr->IsFloat())
+		return std::make_unique<Float>(expr->fValue() * -1.0f);
+	else if (expr->IsFraction())
+		return std::make_unique<Fraction>(-expr->rValue());
+
+	if (expr->IsMul())
+	{
+		std::unique_ptr<Expr> product = OpenChain(ExprType::MUL, std::move(expr));
+		product->AddChild(std::make_unique<Integer>(-1));
+		CloseChain(product);
+
+		return product;
+	}
+
+	return std::make_unique<Mul>(std::make_unique<Integer>(-1), std::move(expr));
+}
+
+std::unique_ptr<Expr> Divide(std::unique_ptr<Expr> left, std::unique_ptr<Expr> right)
+{
+	if (left->IsInteger() && right->IsInteger())
+	{
+		Rational value(left->bValue(), right->bValue());
+
+		if (value.IsInteger())
+			return std::make_unique<Integer>(value.Numerator());
+
+		return std::make_unique<Fraction>(std::move(value));
+	}
+
+	return std::make_unique<Mul>(std::move(left), std::make_unique<Pow>(std::move(right), std::make_unique<Integer>(-1)));
+}
+
+// Right operand of a sum or a product: x-y --> x+(-1)y, x/y --> x(y^-1)
+std::unique_ptr<Expr> Operand(char op, std::unique_ptr<Expr> right)
+{
+	if (op == '-')
+		return Negate(std::move(right));
+	else if (op == '/')
+		return std::make_unique<Pow>(std::move(right), std::make_unique<Integer>(-1));
+
+	return right;
+}
+
+/* A run of the same associative operator is built as one node, the operands of nested
+*  sums or products are taken in as they come:
+*
+*      a+(b+c)-d  -->  +
+*                    / | \ \
+*                   a  b  c  -d
+*
+*  A run of two operands is closed as a binary node, a longer one is sorted.
+*/
+std::unique_ptr<Expr> OpenChain(ExprType type, std::unique_ptr<Expr> first)
+{
+	std::unique_ptr<Expr> chain;
+
+	if (type == ExprType::ADD)
+		chain = std::make_unique<Add>();
+	else
+		chain = std::make_unique<Mul>();
+
+	AppendOperand(chain, std::move(first));
+
+	return chain;
+}
+
+void AppendOperand(std::unique_ptr<Expr>& chain, std::unique_ptr<Expr> operand)
+{
+	if (!operand->IsAssociative() || operand->ExpressionType() != chain->ExpressionType())
+		chain->AddChild(std::move(operand));
+	else if (operand->IsGeneric())
+	{
+		for (int i = 0; i < operand->ChildrenSize(); i++)
+			chain->AddChild(std::move(operand->ChildAt(i)));
+	}
+	else
+	{
+		chain->AddChild(std::move(operand->Left()));
+		chain->AddChild(std::move(operand->Right()));
+	}
+}
+
+void CloseChain(std::unique_ptr<Expr>& chain)
+{
+	if (chain->ChildrenSize() == 1)
+		chain = std::move(chain->ChildAt(0));
+	else if (chain->ChildrenSize() == 2)
+	{
+		if (chain->IsAdd())
+			chain = std::make_unique<Add>(std::move(chain->ChildAt(0)), std::move(chain->ChildAt(1)));
+		else
+			chain = std::make_unique<Mul>(std::move(chain->ChildAt(0)), std::move(chain->ChildAt(1)));
+	}
+	else
+		chain->SortChildren();
+}
+
+bool IsFunctionName(std::string_view name)
+{
+	return name == "log" || name == "log2" || name == "log10" || name == "ln" ||
+	       name == "sin" || name == "cos" || name == "tan" || name == "D" || name == "I";
+}
+
+bool StartsOperand(const Token& token)
+{
+	return token.type == TokenType::NUMBER || token.type == TokenType::VARIABLE ||
+	       token.type == TokenType::PI || token.type == TokenType::FUNCTION ||
+	       token.type == TokenType::LEFT_PARENTHESIS;
+}
+
+int BindingPower(char op)
+{
+	if (op == '+' || op == '-')
+		return add_power;
+	else if (op == '*' || op == '/')
+		return mul_power;
+	else if (op == '^')
+		return pow_power;
+
+	return fac_power;
+}
+
+} // namespace parser
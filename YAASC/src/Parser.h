@@ -0,0 +1,101 @@
+#pragma once
+
+#include <memory>
+#include <string_view>
+
+#include "Expr.h"
+
+namespace parser {
+
+constexpr int add_power = 1;
+constexpr int mul_power = 2; // Also implicit multiplication: 2x, x(y+1), (x+1)(x-1)
+constexpr int pow_power = 3; // Left associative like the old scanner: x^3^4 --> (x^3)^4
+constexpr int fac_power = 4;
+constexpr int unary_power = pow_power; // -x^2 --> -(x^2), -xy --> (-x)y
+
+enum class TokenType
+{
+	NUMBER,
+	VARIABLE,
+	PI,
+	FUNCTION,
+	OPERATOR,
+	LEFT_PARENTHESIS,
+	RIGHT_PARENTHESIS,
+	END
+};
+
+struct Token
+{
+	TokenType type{ TokenType::END };
+	std::string_view text; // Points into the input, tokens own nothing
+};
+
+/* Splits the input into tokens one at a time, in a single pass:
+*
+*      2xsin(y)^-3  -->  2 x sin ( y ) ^ - 3
+*
+*  Letters are single variables, except for pi and for function names that are followed
+*  by a parenthesized argument. Characters that can't start a token are skipped, and a
+*  repeated operator counts once (x++y --> x+y), as they did in scanner::CleanInput().
+*/
+class Lexer
+{
+private:
+	std::string_view m_input;
+	std::size_t m_index{ 0 };
+	std::size_t m_word_end{ 0 }; // End of the run of letters and digits that m_index is in
+	Token m_token;
+
+	void Scan();
+	void SkipIgnored();
+	bool HasArgument(std::size_t index) const;
+
+public:
+	explicit Lexer(std::string_view input) : m_input(input) { Scan(); }
+
+	const Token& Peek() const { return m_token; }
+	void Next() { Scan(); }
+};
+
+/* Precedence climbing parser that builds the expression tree straight from the tokens.
+*  Variables are raised to one, subtraction adds a negated term, division by an integer
+*  gives a fraction, and sums and products of more than two operands are flat generic
+*  nodes, sorted like the simplifier keeps them:
+*
+*      3x-y/2+z  -->  + [ 3x^1, -1 y^1 2^-1, z^1 ]
+*/
+class Parser
+{
+private:
+	Lexer m_lexer;
+
+	std::unique_ptr<Expr> Prefix();
+	std::unique_ptr<Expr> Function(std::string_view name);
+	std::unique_ptr<Expr> Parenthesized();
+	bool Expect(TokenType type);
+
+public:
+	explicit Parser(std::string_view input) : m_lexer(input) {}
+
+	std::unique_ptr<Expr> Expression(int min_power);
+	bool AtEnd() const { return m_lexer.Peek().type == TokenType::END; }
+};
+
+std::unique_ptr<Expr> Parse(std::string_view input); // Null when the input is malformed
+
+std::unique_ptr<Expr> Number(std::string_view digits);
+std::unique_ptr<Expr> Variable(char name);
+std::unique_ptr<Expr> Negate(std::unique_ptr<Expr> expr);
+std::unique_ptr<Expr> Divide(std::unique_ptr<Expr> left, std::unique_ptr<Expr> right);
+std::unique_ptr<Expr> Operand(char op, std::unique_ptr<Expr> right);
+
+std::unique_ptr<Expr> OpenChain(ExprType type, std::unique_ptr<Expr> first);
+void AppendOperand(std::unique_ptr<Expr>& chain, std::unique_ptr<Expr> operand);
+void CloseChain(std::unique_ptr<Expr>& chain);
+
+bool IsFunctionName(std::string_view name);
+bool StartsOperand(const Token& token);
+int BindingPower(char op);
+
+} // namespace parser
@@ -0,0 +1,632 @@
+#include <algorithm>
+
+#include "Polynomial.h"
+#include "Parallel.h"
+
+namespace poly {
+
+Polynomial::Polynomial(BigInt constant)
+{
+	if (!constant.IsZero())
+		m_coefficients.push_back(std::move(constant));
+}
+
+Polynomial::Polynomial(const Rational& constant)
+	: Polynomial(constant.Numerator())
+{
+	m_denominator = constant.Denominator();
+}
+
+Polynomial Polynomial::Variable(symbol::Id id, Exponent exponent)
+{
+	Polynomial polynomial;
+	polynomial.m_variables.push_back(id);
+	polynomial.Push(&exponent, 1);
+
+	return polynomial;
+}
+
+Exponent Polynomial::MaxExponent() const
+{
+	return m_exponents.empty() ? 0 : *std::max_element(m_exponents.begin(), m_exponents.end());
+}
+
+// Appends a term that comes after all the others, or adds it to the last one when they are alike
+void Polynomial::Push(const Exponent* exponents, BigInt coefficient)
+{
+	int arity = Arity();
+
+	if (!IsZero() && CompareMonomials(Exponents(Terms() - 1), exponents, arity) == 0)
+	{
+		m_coefficients.back() += coefficient;
+
+		if (m_coefficients.back().IsZero())
+		{
+			m_coefficients.pop_back();
+			m_exponents.resize(m_exponents.size() - arity);
+		}
+	}
+	else if (!coefficient.IsZero())
+	{
+		m_exponents.insert(m_exponents.end(), exponents, exponents + arity);
+		m_coefficients.push_back(std::move(coefficient));
+	}
+}
+
+// The same polynomial over more variables. Zero columns leave the order of the terms as it is.
+Polynomial Polynomial::Over(const std::vector<symbol::Id>& variables) const
+{
+	if (variables == m_variables)
+		return *this;
+
+	Polynomial result;
+	result.m_variables = variables;
+	result.m_coefficients = m_coefficients;
+	result.m_denominator = m_denominator;
+	result.m_exponents.assign(m_coefficients.size() * variables.size(), 0);
+
+	std::vector<std::size_t> column(m_variables.size());
+
+	for (std::size_t i = 0, j = 0; i < m_variables.size(); i++)
+	{
+		while (variables[j] != m_variables[i])
+			j++;
+
+		column[i] = j;
+	}
+
+	for (int t = 0; t < Terms(); t++)
+	{
+		for (std::size_t i = 0; i < m_variables.size(); i++)
+			result.m_exponents[t * variables.size() + column[i]] = Exponents(t)[i];
+	}
+
+	return result;
+}
+
+// Terms [begin, end), still sorted
+Polynomial Polynomial::Slice(int begin, int end) const
+{
+	Polynomial result;
+	result.m_variables = m_variables;
+	result.m_exponents.assign(m_exponents.begin() + (std::size_t)begin * Arity(), m_exponents.begin() + (std::size_t)end * Arity());
+	result.m_coefficients.assign(m_coefficients.begin() + begin, m_coefficients.begin() + end);
+	result.m_denominator = m_denominator;
+
+	return result;
+}
+
+// Divides the denominator and the coefficients by their common factor
+void Polynomial::Reduce()
+{
+	if (m_denominator == 1)
+		return;
+
+	if (IsZero())
+	{
+		m_denominator = 1;
+		return;
+	}
+
+	BigInt divisor = m_denominator;
+
+	for (int t = 0; t < Terms() && !(divisor == 1); t++)
+		divisor = Gcd(divisor, m_coefficients[t]);
+
+	if (divisor == 1)
+		return;
+
+	for (BigInt& coefficient : m_coefficients)
+		coefficient = coefficient / divisor;
+
+	m_denominator = m_denominator / divisor;
+}
+
+bool Polynomial::IsDense() const
+{
+	return Arity() == 1 && Terms() >= 2 && 2.0 * Terms() > Exponents(0)[0] + 1.0;
+}
+
+Dense Polynomial::ToDense() const
+{
+	Dense coefficients(IsZero() ? 0 : Exponents(0)[0] + 1);
+
+	for (int t = 0; t < Terms(); t++)
+		coefficients[Exponents(t)[0]] = Coefficient(t);
+
+	return coefficients;
+}
+
+Polynomial Polynomial::FromDense(symbol::Id id, const Dense& coefficients)
+{
+	Polynomial polynomial;
+	polynomial.m_variables.push_back(id);
+
+	for (std::size_t k = coefficients.size(); k-- > 0;)
+	{
+		Exponent exponent = (Exponent)k;
+		polynomial.Push(&exponent, coefficients[k]);
+	}
+
+	return polynomial;
+}
+
+Polynomial Polynomial::Pow(unsigned n) const
+{
+	if (n == 0)
+		return Polynomial(1);
+
+	// Powers of dense polynomials stay dense, squaring lets the transform do the work
+	if (IsDense())
+	{
+		Polynomial result(1);
+		Polynomial square = *this;
+
+		for (; n > 0; n >>= 1)
+		{
+			if (n & 1)
+				result = result * square;
+
+			if (n > 1)
+				square = square * square;
+		}
+
+		return result;
+	}
+
+	// Multiplying by the short base each time beats squaring, the squares of sparse polynomials are long
+	Polynomial result = *this;
+
+	for (unsigned i = 1; i < n; i++)
+		result = result * *this;
+
+	return result;
+}
+
+Polynomial operator+(const Polynomial& a, const Polynomial& b)
+{
+	std::vector<symbol::Id> variables = MergeVariables(a.m_variables, b.m_variables);
+	Polynomial x = a.Over(variables);
+	Polynomial y = b.Over(variables);
+
+	Polynomial sum;
+	sum.m_variables = variables;
+
+	// Over the least common denominator
+	if (!(a.m_denominator == b.m_denominator))
+	{
+		BigInt gcd = Gcd(a.m_denominator, b.m_denominator);
+		BigInt x_factor = b.m_denominator / gcd;
+		BigInt y_factor = a.m_denominator / gcd;
+
+		for (BigInt& coefficient : x.m_coefficients)
+			coefficient = coefficient * x_factor;
+
+		for (BigInt& coefficient : y.m_coefficients)
+			coefficient = coefficient * y_factor;
+
+		sum.m_denominator = a.m_denominator * x_factor;
+	}
+	else
+		sum.m_denominator = a.m_denominator;
+
+	int arity = sum.Arity();
+	int i = 0;
+	int j = 0;
+
+	while (i < x.Terms() || j < y.Terms())
+	{
+		int order = i == x.Terms() ? -1 : j == y.Terms() ? 1 : CompareMonomials(x.Exponents(i), y.Exponents(j), arity);
+
+		if (order > 0)
+		{
+			sum.Push(x.Exponents(i), x.Coefficient(i));
+			i++;
+		}
+		else if (order < 0)
+		{
+			sum.Push(y.Exponents(j), y.Coefficient(j));
+			j++;
+		}
+		else
+		{
+			sum.Push(x.Exponents(i), x.Coefficient(i) + y.Coefficient(j));
+			i++;
+			j++;
+		}
+	}
+
+	sum.Reduce();
+
+	return sum;
+}
+
+/* Monagan and Pearce's heap multiplication. Row i of the product is x_i times y_0, y_1, ...,
+*  and the heap holds the next term of every row that has started, keyed by its monomial.
+*  Terms come off the heap in order with the like ones together, so the product is built
+*  sorted and merged, and the working memory is one entry per term of the shorter factor.
+*  Row i + 1 starts when row i takes its first term, its terms can't be larger before that.
+*/
+Polynomial HeapProduct(const Polynomial& a, const Polynomial& b)
+{
+	const Polynomial& x = a.Terms() <= b.Terms() ? a : b;
+	const Polynomial& y = a.Terms() <= b.Terms() ? b : a;
+
+	Polynomial product;
+	product.m_variables = x.m_variables;
+
+	int arity = product.Arity();
+	std::vector<int> column(x.Terms(), 0);
+	std::vector<Exponent> monomials((std::size_t)x.Terms() * arity);
+	std::vector<int> heap;
+	std::vector<int> popped;
+	heap.reserve(x.Terms());
+
+	auto monomial = [&](int i) { return monomials.data() + (std::size_t)i * arity; };
+	auto less = [&](int i, int k) { return CompareMonomials(monomial(i), monomial(k), arity) < 0; };
+
+	auto insert = [&](int i) {
+		for (int k = 0; k < arity; k++)
+			monomial(i)[k] = x.Exponents(i)[k] + y.Exponents(column[i])[k];
+
+		heap.push_back(i);
+		std::push_heap(heap.begin(), heap.end(), less);
+	};
+
+	insert(0);
+
+	while (!heap.empty())
+	{
+		BigInt coefficient = 0;
+		popped.clear();
+
+		do
+		{
+			int i = heap.front();
+			std::pop_heap(heap.begin(), heap.end(), less);
+			heap.pop_back();
+
+			coefficient += x.Coefficient(i) * y.Coefficient(column[i]);
+			popped.push_back(i);
+		} while (!heap.empty() && CompareMonomials(monomial(heap.front()), monomial(popped[0]), arity) == 0);
+
+		product.Push(monomial(popped[0]), std::move(coefficient));
+
+		for (int i : popped)
+		{
+			if (column[i] == 0 && i + 1 < x.Terms())
+				insert(i + 1);
+
+			if (++column[i] < y.Terms())
+				insert(i);
+		}
+	}
+
+	product.m_denominator = x.m_denominator * y.m_denominator;
+	product.Reduce();
+
+	return product;
+}
+
+/* Large products are split into blocks of the longer factor, and every thread multiplies
+*  blocks into sorted runs:
+*
+*      x * (y0 y1 y2 y3 y4 y5)  -->  x*(y0 y1)  x*(y2 y3)  x*(y4 y5)
+*
+*  The runs are then merged in pairs, always the same pairs, so the product doesn't depend
+*  on the number of threads.
+*/
+Polynomial operator*(const Polynomial& a, const Polynomial& b)
+{
+	std::vector<symbol::Id> variables = MergeVariables(a.m_variables, b.m_variables);
+
+	if (a.IsZero() || b.IsZero())
+		return Polynomial().Over(variables);
+
+	// The numerators are multiplied as integer polynomials
+	if (!(a.m_denominator == 1) || !(b.m_denominator == 1))
+	{
+		Polynomial x = a;
+		Polynomial y = b;
+		x.m_denominator = 1;
+		y.m_denominator = 1;
+
+		Polynomial product = x * y;
+		product.m_denominator = a.m_denominator * b.m_denominator;
+		product.Reduce();
+
+		return product;
+	}
+
+	Polynomial x = a.Over(variables);
+	Polynomial y = b.Over(variables);
+
+	if (x.Terms() > y.Terms())
+		std::swap(x, y);
+
+	if (x.IsDense() && y.IsDense() && (std::size_t)x.Terms() >= dense_ntt_threshold)
+		return Polynomial::FromDense(variables[0], Multiply(x.ToDense(), y.ToDense()));
+
+	parallel::ThreadPool& pool = parallel::Pool();
+
+	if ((double)x.Terms() * y.Terms() < min_parallel_products || pool.Threads() == 1 || y.Terms() < 2)
+		return HeapProduct(x, y);
+
+	int blocks = std::min(y.Terms(), pool.Threads() * parallel::chunks_per_thread);
+	std::vector<Polynomial> runs(blocks);
+
+	pool.ForEach(blocks, [&](int k) {
+		runs[k] = HeapProduct(x, y.Slice((int)((long long)y.Terms() * k / blocks), (int)((long long)y.Terms() * (k + 1) / blocks)));
+	});
+
+	for (int step = 1; step < blocks; step *= 2)
+	{
+		pool.ForEach((blocks + 2 * step - 1) / (2 * step), [&](int pair) {
+			int k = pair * 2 * step;
+
+			if (k + step < blocks)
+				runs[k] = runs[k] + runs[k + step];
+		});
+	}
+
+	return std::move(runs[0]);
+}
+
+bool operator==(const Polynomial& a, const Polynomial& b)
+{
+	if (!(a.m_denominator == b.m_denominator))
+		return false;
+
+	if (a.m_variables == b.m_variables)
+		return a.m_exponents == b.m_exponents && a.m_coefficients == b.m_coefficients;
+
+	// Variables that only occur with exponent 0 don't make polynomials different
+	std::vector<symbol::Id> variables = MergeVariables(a.m_variables, b.m_variables);
+	Polynomial x = a.Over(variables);
+	Polynomial y = b.Over(variables);
+
+	return x.m_exponents == y.m_exponents && x.m_coefficients == y.m_coefficients;
+}
+
+std::vector<symbol::Id> MergeVariables(const std::vector<symbol::Id>& a, const std::vector<symbol::Id>& b)
+{
+	if (a == b || b.empty())
+		return a;
+	else if (a.empty())
+		return b;
+
+	std::vector<symbol::Id> variables;
+	std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(variables), symbol::Less);
+
+	return variables;
+}
+
+int CompareMonomials(const Exponent* a, const Exponent* b, int arity)
+{
+	for (int k = 0; k < arity; k++)
+	{
+		if (a[k] != b[k])
+			return a[k] > b[k] ? 1 : -1;
+	}
+
+	return 0;
+}
+
+// C(n+m-1, m-1), the number of monomials of degree n in m unknowns
+double PowerTerms(double terms, unsigned n)
+{
+	if (terms <= 1)
+		return terms;
+
+	double top = n + terms - 1;
+	double k_max = std::min(terms - 1, (double)n);
+	double result = 1;
+
+	for (double k = 1; k <= k_max && result <= max_terms; k++)
+		result = result * (top - k_max + k) / k;
+
+	return result;
+}
+
+static int OperandCount(const std::unique_ptr<Expr>& expr)
+{
+	return expr->IsGeneric() ? expr->ChildrenSize() : 2;
+}
+
+static const std::unique_ptr<Expr>& Operand(const std::unique_ptr<Expr>& expr, int k)
+{
+	return expr->IsGeneric() ? expr->ChildAt(k) : (k == 0 ? expr->Left() : expr->Right());
+}
+
+bool FromExpr(const std::unique_ptr<Expr>& expr, Polynomial& polynomial)
+{
+	if (!expr)
+		return false;
+
+	switch (expr->ExpressionType())
+	{
+	case ExprType::INTEGER:
+		polynomial = Polynomial(expr->bValue());
+		return true;
+	case ExprType::FRACTION:
+		if (expr->rValue().Denominator().IsZero())
+			return false;
+
+		polynomial = Polynomial(expr->rValue());
+		return true;
+	case ExprType::VARIABLE:
+		polynomial = Polynomial::Variable(expr->Symbol());
+		return true;
+	case ExprType::ADD:
+	{
+		std::vector<Polynomial> operands(OperandCount(expr));
+
+		for (int k = 0; k < OperandCount(expr); k++)
+		{
+			if (!FromExpr(Operand(expr, k), operands[k]))
+				return false;
+		}
+
+		// Pairwise, so long sums are merged in n log n
+		for (std::size_t step = 1; step < operands.size(); step *= 2)
+		{
+			for (std::size_t k = 0; k + step < operands.size(); k += 2 * step)
+				operands[k] = operands[k] + operands[k + step];
+		}
+
+		polynomial = std::move(operands[0]);
+		return true;
+	}
+	case ExprType::MUL:
+	{
+		Polynomial product(1);
+
+		for (int k = 0; k < OperandCount(expr); k++)
+		{
+			Polynomial operand;
+
+			if (!FromExpr(Operand(expr, k), operand))
+				return false;
+
+			if ((double)product.Terms() * operand.Terms() > max_terms)
+				return false;
+
+			if ((double)product.MaxExponent() + operand.MaxExponent() >= max_exponent)
+				return false;
+
+			product = product * operand;
+		}
+
+		polynomial = std::move(product);
+		return true;
+	}
+	case ExprType::POW:
+	{
+		const std::unique_ptr<Expr>& exponent = expr->Right();
+
+		if (!exponent->IsInteger() || exponent->bValue().Sign() < 0 || !exponent->bValue().FitsInt())
+			return false;
+
+		Polynomial base;
+
+		if (!FromExpr(expr->Left(), base))
+			return false;
+
+		unsigned n = exponent->bValue().ToInt();
+
+		if (PowerTerms(base.Terms(), n) > max_terms || (double)base.MaxExponent() * n >= max_exponent)
+			return false;
+
+		polynomial = base.Pow(n);
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+static std::unique_ptr<Expr> Close(std::unique_ptr<Expr> chain)
+{
+	if (chain->ChildrenSize() == 1)
+		return std::move(chain->ChildAt(0));
+	else if (chain->ChildrenSize() == 2 && chain->IsAdd())
+		return std::make_unique<Add>(std::move(chain->ChildAt(0)), std::move(chain->ChildAt(1)));
+	else if (chain->ChildrenSize() == 2)
+		return std::make_unique<Mul>(std::move(chain->ChildAt(0)), std::move(chain->ChildAt(1)));
+
+	return chain;
+}
+
+// Terms in the order of the polynomial, each a coefficient and powers of the variables: 3x^2y --> 3*x^2*y^1
+std::unique_ptr<Expr> ToExpr(const Polynomial& polynomial)
+{
+	if (polynomial.IsZero())
+		return std::make_unique<Integer>(0);
+
+	std::unique_ptr<Expr> sum = std::make_unique<Add>();
+
+	for (int t = 0; t < polynomial.Terms(); t++)
+	{
+		std::unique_ptr<Expr> term = std::make_unique<Mul>();
+		Rational coefficient(polynomial.Coefficient(t), polynomial.Denominator());
+		const Exponent* exponents = polynomial.Exponents(t);
+
+		if (!(coefficient == Rational(1)) || std::all_of(exponents, exponents + polynomial.Arity(), [](Exponent e) { return e == 0; }))
+		{
+			if (coefficient.IsInteger())
+				term->AddChild(std::make_unique<Integer>(coefficient.Numerator()));
+			else
+				term->AddChild(std::make_unique<Fraction>(coefficient));
+		}
+
+		for (int k = 0; k < polynomial.Arity(); k++)
+		{
+			if (exponents[k] != 0)
+				term->AddChild(std::make_unique<Pow>(std::make_unique<Var>(polynomial.Variables()[k]), std::make_unique<Integer>(BigInt((long long)exponents[k]))));
+		}
+
+		sum->AddChild(Close(std::move(term)));
+	}
+
+	return Close(std::move(sum));
+}
+
+static bool HasSumOperand(const std::unique_ptr<Expr>& expr)
+{
+	for (int k = 0; k < OperandCount(expr); k++)
+	{
+		if (Operand(expr, k)->IsAdd())
+			return true;
+	}
+
+	return false;
+}
+
+bool Expand(std::unique_ptr<Expr>& expr)
+{
+	bool expandable = false;
+
+	if (expr->IsPow())
+		expandable = expr->Left()->IsAdd() && expr->Right()->IsInteger() && Compare(expr->Right()->bValue(), 2) >= 0;
+	else if (expr->IsMul())
+		expandable = HasSumOperand(expr);
+
+	Polynomial polynomial;
+
+	if (!expandable || !FromExpr(expr, polynomial))
+		return false;
+
+	expr = ToExpr(polynomial);
+	expr->Rehash();
+
+	return true;
+}
+
+static int Summands(const std::unique_ptr<Expr>& expr)
+{
+	if (!expr->IsAdd())
+		return 1;
+
+	int count = 0;
+
+	for (int k = 0; k < OperandCount(expr); k++)
+		count += Summands(Operand(expr, k));
+
+	return count;
+}
+
+bool CollectTerms(std::unique_ptr<Expr>& expr)
+{
+	Polynomial polynomial;
+
+	// Only when terms are gone, otherwise this would undo the ordering of the other rules
+	if (!expr->IsAdd() || !FromExpr(expr, polynomial) || polynomial.Terms() >= Summands(expr))
+		return false;
+
+	expr = ToExpr(polynomial);
+	expr->Rehash();
+
+	return true;
+}
+
+} // namespace poly
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "Expr.h"
+#include "Dense.h"
+
+namespace poly {
+
+using Exponent = std::uint32_t;
+
+constexpr std::size_t max_terms = 1 << 20;   // Expansions that could get larger are left to the tree rules
+constexpr Exponent max_exponent = 1 << 24;   // Keeps sums of exponents far from overflowing
+constexpr double min_parallel_products = 1 << 15; // Smaller products are multiplied by the calling thread
+
+/* Sparse distributed polynomial with rational coefficients. The variables are interned
+*  symbols kept in symbol::Less order, and a term is its exponent vector over them and a
+*  nonzero integer numerator over the shared denominator. Terms are sorted by their
+*  exponents, highest first:
+*
+*      3x^2y - 2y^3 + 5    variables: x y
+*                          exponents: 2 1 | 0 3 | 0 0
+*                          coefficients: 3, -2, 5
+*
+*  so adding is a merge, and equal polynomials have equal arrays. Fractions share one
+*  denominator, coprime to the coefficients, so the arithmetic stays on integers:
+*
+*      1/2x + 1/3          coefficients: 3, 2    denominator: 6
+*/
+class Polynomial
+{
+private:
+	std::vector<symbol::Id> m_variables;
+	std::vector<Exponent> m_exponents;      // Term t: [t * Arity(), (t + 1) * Arity())
+	std::vector<BigInt> m_coefficients;
+	BigInt m_denominator{ 1 };
+
+	void Push(const Exponent* exponents, BigInt coefficient);
+	Polynomial Over(const std::vector<symbol::Id>& variables) const;
+	Polynomial Slice(int begin, int end) const;
+	void Reduce();
+
+	friend Polynomial HeapProduct(const Polynomial& x, const Polynomial& y);
+
+public:
+	Polynomial() {}
+	Polynomial(BigInt constant);
+	Polynomial(const Rational& constant);
+
+	static Polynomial Variable(symbol::Id id, Exponent exponent = 1);
+
+	int Terms() const { return (int)m_coefficients.size(); }
+	int Arity() const { return (int)m_variables.size(); }
+	bool IsZero() const { return m_coefficients.empty(); }
+
+	const std::vector<symbol::Id>& Variables() const { return m_variables; }
+	const Exponent* Exponents(int t) const { return m_exponents.data() + (std::size_t)t * m_variables.size(); }
+	const BigInt& Coefficient(int t) const { return m_coefficients[t]; } // Over Denominator()
+	const BigInt& Denominator() const { return m_denominator; }
+	Exponent MaxExponent() const;
+
+	Polynomial Pow(unsigned n) const;
+
+	// Univariate polynomials with at least half of their coefficients nonzero go through Dense
+	bool IsDense() const;
+	Dense ToDense() const;
+	static Polynomial FromDense(symbol::Id id, const Dense& coefficients);
+
+	friend Polynomial operator+(const Polynomial& a, const Polynomial& b);
+	friend Polynomial operator*(const Polynomial& a, const Polynomial& b);
+	friend bool operator==(const Polynomial& a, const Polynomial& b);
+};
+
+std::vector<symbol::Id> MergeVariables(const std::vector<symbol::Id>& a, const std::vector<symbol::Id>& b);
+int CompareMonomials(const Exponent* a, const Exponent* b, int arity);
+Polynomial HeapProduct(const Polynomial& a, const Polynomial& b); // By the calling thread alone, operator* splits large products
+double PowerTerms(double terms, unsigned n); // Most terms that a polynomial of so many terms can have when raised to n
+
+// Integers, fractions, variables, and sums, products and natural powers of them. False for anything else.
+bool FromExpr(const std::unique_ptr<Expr>& expr, Polynomial& polynomial);
+std::unique_ptr<Expr> ToExpr(const Polynomial& polynomial);
+
+bool Expand(std::unique_ptr<Expr>& expr);       // (a+b)^n, a(b+c), when they are polynomials
+bool CollectTerms(std::unique_ptr<Expr>& expr); // Sums of monomials with like terms
+
+} // namespace poly
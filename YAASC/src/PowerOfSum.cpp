@@ -4,7 +4,7 @@ namespace algebra {
 
 void PowerOfSum(std::unique_ptr<Expr>& expr)
 {
-	if (expr->IsTerminal() || expr->IsFunc())
+	if (expr->IsTerminal() || expr->IsFunc() || expr->Settled())
 		return;
 
 	if (expr->IsGeneric())
@@ -21,18 +21,30 @@ void PowerOfSum(std::unique_ptr<Expr>& expr)
 			PowerOfSum(expr->Right());
 	}
 
+	expr->Rehash();
+	PowerOfSumNode(expr);
+}
+
+void PowerOfSumNode(std::unique_ptr<Expr>& expr)
+{
 	if (!expr->IsPow())
 		return;
 
 	if (!CanApplyPowerOfSum(expr))
 		return;
 
-	// (a+b)^n
-	if (!expr->Left()->IsGeneric())
-		ApplyBinomialTheorem(expr);
-	// (a1+a2+...am)^n
-	else
+	// (a1+a2+...am)^n, polynomial or not
+	if (expr->Left()->IsGeneric())
+	{
 		ApplyMultinomialTheorem(expr);
+		return;
+	}
+
+	if (poly::Expand(expr))
+		return;
+
+	// (a+b)^n
+	ApplyBinomialTheorem(expr);
 }
 
 // (a+b)^n
@@ -45,15 +57,11 @@ void ApplyBinomialTheorem(std::unique_ptr<Expr>& expr) // FIXME: How about (a+b)
 	std::unique_ptr<Expr> add_node = std::move(expr->Left());
 	std::unique_ptr<Expr> new_add_node = std::make_unique<Add>();
 
-	int coefficient = 1;
+	BigInt coefficient = 1;
 	int n = exponent->iValue();
-	int numerator = calc::Factorial(n);
 
 	for (int i = 0; i <= n; i++)
 	{
-		int denominator = calc::Factorial(i) * calc::Factorial(n - i);
-		coefficient = numerator / denominator;
-
 		std::unique_ptr<Expr> mul_node = std::make_unique<Mul>();
 		std::unique_ptr<Expr> expr_a;
 		std::unique_ptr<Expr> expr_b;
@@ -70,15 +78,106 @@ void ApplyBinomialTheorem(std::unique_ptr<Expr>& expr) // FIXME: How about (a+b)
 			mul_node->AddChild(std::move(std::make_unique<Pow>(std::move(expr_b), std::make_unique<Integer>(i))));
 
 		new_add_node->AddChild(std::move(mul_node));
+
+		// C(n, i + 1) = C(n, i)(n - i)/(i + 1), exact at every step
+		coefficient = coefficient * (n - i) / (i + 1);
 	}
 
 	expr = std::move(new_add_node);
 }
 
-// (a1+a2+...+am)^n
+/* Terms of (a1+a2+...+am)^n with k1 = first, one for each k1+k2+...+km = n, taken down
+*  from (first,n-first,0,...,0):
+*
+*      n = 3, first = 1:  (1,2,0) (1,1,1) (1,0,2)
+*
+*  The next composition moves one from the last nonzero k_j before km to k_j+1, together
+*  with all of km. Either way n!/(k1!...km!) changes by k_j/(km + 1), exactly.
+*/
+static void MultinomialTerms(std::unique_ptr<Expr>& add_node, int n, int first, std::vector<std::unique_ptr<Expr>>& terms)
+{
+	int m = add_node->ChildrenSize();
+	std::vector<int> k(m, 0);
+	BigInt coefficient = 1;
+	k[0] = first;
+	k[1] = n - first;
+
+	for (int i = 0; i < first; i++)
+		coefficient = coefficient * (n - i) / (i + 1);
+
+	while (true)
+	{
+		std::unique_ptr<Expr> mul_node = std::make_unique<Mul>();
+		mul_node->AddChild(std::make_unique<Integer>(coefficient));
+
+		for (int i = 0; i < m; i++)
+		{
+			if (k[i] == 0)
+				continue;
+
+			std::unique_ptr<Expr> summand;
+			tree_util::Clone(summand, add_node->ChildAt(i));
+			mul_node->AddChild(std::make_unique<Pow>(std::move(summand), std::make_unique<Integer>(k[i])));
+		}
+
+		terms.push_back(std::move(mul_node));
+
+		int last = k[m - 1];
+		int j = m - 2;
+		k[m - 1] = 0;
+
+		while (j >= 1 && k[j] == 0)
+			j--;
+
+		if (j < 1)
+			break;
+
+		coefficient = coefficient * k[j] / (last + 1);
+		k[j]--;
+		k[j + 1] = last + 1;
+	}
+}
+
+// (a1+a2+...+am)^n, the terms for each value of k1 in parallel, put together from k1 = n down
 void ApplyMultinomialTheorem(std::unique_ptr<Expr>& expr)
-{	
-	(void)expr;
+{
+	std::unique_ptr<Expr>& exponent = expr->Right();
+
+	if (exponent->bValue() < 2 || !exponent->bValue().FitsInt())
+		return;
+
+	int n = exponent->iValue();
+	double terms = poly::PowerTerms(expr->Left()->ChildrenSize(), n);
+
+	if (terms > poly::max_terms)
+		return;
+
+	std::unique_ptr<Expr> add_node = std::move(expr->Left());
+	std::unique_ptr<Expr> new_add_node = std::make_unique<Add>();
+	std::vector<std::vector<std::unique_ptr<Expr>>> groups(n + 1);
+
+	if (terms < parallel::min_parallel_children)
+	{
+		for (int first = n; first >= 0; first--)
+			MultinomialTerms(add_node, n, first, groups[n - first]);
+	}
+	else
+	{
+		Expr::GenerationState state = Expr::CurrentGenerationState();
+
+		parallel::Pool().ForEach(n + 1, [&](int group) {
+			Expr::SetGenerationState(state);
+			MultinomialTerms(add_node, n, n - group, groups[group]);
+		});
+	}
+
+	for (std::vector<std::unique_ptr<Expr>>& group : groups)
+	{
+		for (std::unique_ptr<Expr>& term : group)
+			new_add_node->AddChild(std::move(term));
+	}
+
+	expr = std::move(new_add_node);
 }
 
 bool CanApplyPowerOfSum(const std::unique_ptr<Expr>& expr)
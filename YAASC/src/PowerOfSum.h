@@ -3,10 +3,13 @@
 #include "Expr.h"
 #include "TreeUtil.h"
 #include "Calculator.h"
+#include "Polynomial.h"
+#include "Parallel.h"
 
 namespace algebra {
 
 void PowerOfSum(std::unique_ptr<Expr>& expr);
+void PowerOfSumNode(std::unique_ptr<Expr>& expr);
 void ApplyBinomialTheorem(std::unique_ptr<Expr>& expr);
 void ApplyMultinomialTheorem(std::unique_ptr<Expr>& expr);
 
@@ -15,7 +15,7 @@ void ApplyExponentRules(std::unique_ptr<Expr>& root)
 // (a^n)(a^m) --> a^(n+m)
 void ExponentRuleMul(std::unique_ptr<Expr>& root)
 {
-	if (root->IsTerminal())
+	if (root->IsTerminal() || root->Settled())
 		return;
 
 	if (root->IsGeneric())
@@ -32,6 +32,12 @@ void ExponentRuleMul(std::unique_ptr<Expr>& root)
 			ExponentRuleMul(root->Right());
 	}
 
+	root->Rehash();
+	ExponentRuleMulNode(root);
+}
+
+void ExponentRuleMulNode(std::unique_ptr<Expr>& root)
+{
 	if (!root->IsMul())
 		return;
 
@@ -45,13 +51,13 @@ void ApplyExponentRuleMulBinNode(std::unique_ptr<Expr>& root)
 {
 	if (SameVariables(root->Left()->Left(), root->Right()->Left()))
 	{
-		std::string var = root->Left()->Left()->Name();
+		symbol::Id var = root->Left()->Left()->Symbol();
 
 		if (CanApplyExponentRule(root, var))
 		{
 			std::unique_ptr<Expr> exponent;
 			exponent = std::move(calc::AddNumbers(root->Left()->Right(), root->Right()->Right()));
-			root = std::move(std::make_unique<Pow>(std::make_unique<Var>(var), std::move(exponent)));
+			root = std::move(std::make_unique<Pow>(std::move(root->Left()->Left()), std::move(exponent)));
 		}
 	}
 }
@@ -61,6 +67,22 @@ void ApplyExponentRuleMulGenNode(std::unique_ptr<Expr>& root)
 	std::queue<std::unique_ptr<Expr>> new_children;
 	std::unique_ptr<Expr> exponent = nullptr;
 	bool modified = false;
+	bool can_merge = false;
+
+	for (int i = 0; i + 1 < root->ChildrenSize(); i++)
+	{
+		if (PowWithNumberExponents(root->ChildAt(i), root->ChildAt(i + 1)) && root->ChildAt(i)->Left() == root->ChildAt(i + 1)->Left())
+		{
+			can_merge = true;
+			break;
+		}
+	}
+
+	if (!can_merge && root->ChildrenSize() > 1) // Children would be moved back as they are
+	{
+		root->SortChildren();
+		return;
+	}
 
 	for (int i = 0; i != root->ChildrenSize(); i++)
 	{
@@ -115,7 +137,7 @@ void ApplyExponentRuleMulGenNode(std::unique_ptr<Expr>& root)
 // a^n^m --> a^(nm)
 void ExponentRulePow(std::unique_ptr<Expr>& root)
 {
-	if (root->IsTerminal())
+	if (root->IsTerminal() || root->Settled())
 		return;
 	
 	if (root->IsGeneric())
@@ -132,22 +154,26 @@ void ExponentRulePow(std::unique_ptr<Expr>& root)
 			ExponentRulePow(root->Right());
 	}
 
+	root->Rehash();
+	ExponentRulePowNode(root);
+}
+
+void ExponentRulePowNode(std::unique_ptr<Expr>& root)
+{
 	if (root->IsPow() && root->Left()->IsPow() && root->Right()->IsNumber())
 	{
-		std::string value = "";
+		symbol::Id value = symbol::none;
 
 		if (root->Left()->HasLeftChild())
-		{
-			if (root->Left()->Left()->IsVar())
-				value = root->Left()->Left()->Name();
-		}
+			value = root->Left()->Left()->Symbol();
 
 		if (root->Left()->HasRightChild())
 		{
-			if (root->Left()->Right()->IsNumber() && value != "")
+			if (root->Left()->Right()->IsNumber() && value != symbol::none)
 			{
 				std::unique_ptr<Expr> exponent = std::move(calc::MulNumbers(root->Right(), root->Left()->Right()));
-				root = std::move(std::make_unique<Pow>(std::make_unique<Var>(value), std::move(exponent)));
+				// The base is moved, not rebuilt from its symbol, so e and pi keep their kind
+				root = std::move(std::make_unique<Pow>(std::move(root->Left()->Left()), std::move(exponent)));
 			}
 		}
 	}
@@ -156,7 +182,7 @@ void ExponentRulePow(std::unique_ptr<Expr>& root)
 // (ab)^n --> (a^n)(b^n)
 void ExponentRuleParenthesis(std::unique_ptr<Expr>& root)
 {
-	if (root->IsTerminal())
+	if (root->IsTerminal() || root->Settled())
 		return;
 
 	if (root->IsGeneric())
@@ -173,6 +199,12 @@ void ExponentRuleParenthesis(std::unique_ptr<Expr>& root)
 			ExponentRuleParenthesis(root->Right());
 	}
 
+	root->Rehash();
+	ExponentRuleParenthesisNode(root);
+}
+
+void ExponentRuleParenthesisNode(std::unique_ptr<Expr>& root)
+{
 	if (!root->IsPow())
 		return;
 
@@ -230,16 +262,16 @@ bool PowWithNumberExponents(const std::unique_ptr<Expr>& expr_a, const std::uniq
 	return true;
 }
 
-bool CanApplyExponentRule(const std::unique_ptr<Expr>& expr, std::string value)
+bool CanApplyExponentRule(const std::unique_ptr<Expr>& expr, symbol::Id value)
 {
 	if (expr->Left()->HasChildren())
 	{
-		if (expr->Left()->Left()->Name() == value && expr->Left()->Right()->IsNumber())
+		if (expr->Left()->Left()->Symbol() == value && expr->Left()->Right()->IsNumber())
 			return true;
 	}
 	else if (expr->Right()->HasChildren())
 	{
-		if (expr->Right()->Left()->Name() == value && expr->Right()->Right()->IsNumber())
+		if (expr->Right()->Left()->Symbol() == value && expr->Right()->Right()->IsNumber())
 			return true;
 	}
 
@@ -254,7 +286,7 @@ bool SameVariables(const std::unique_ptr<Expr>& expr_a, const std::unique_ptr<Ex
 	if (!expr_b->IsVar())
 		return false;
 
-	if (expr_a->Name() == expr_b->Name())
+	if (expr_a->Symbol() == expr_b->Symbol())
 		return true;
 
 	return false;
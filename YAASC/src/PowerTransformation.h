@@ -10,14 +10,17 @@ namespace algebra {
 
 void ApplyExponentRules(std::unique_ptr<Expr>& root);
 void ExponentRuleMul(std::unique_ptr<Expr>& root);
+void ExponentRuleMulNode(std::unique_ptr<Expr>& root);
 void ApplyExponentRuleMulBinNode(std::unique_ptr<Expr>& root);
 void ApplyExponentRuleMulGenNode(std::unique_ptr<Expr>& root);
 void ExponentRulePow(std::unique_ptr<Expr>& root);
+void ExponentRulePowNode(std::unique_ptr<Expr>& root);
 void ExponentRuleParenthesis(std::unique_ptr<Expr>& root);
+void ExponentRuleParenthesisNode(std::unique_ptr<Expr>& root);
 void HandleExponentRuleParenthesis(std::unique_ptr<Expr>& base, std::unique_ptr<Expr>& exponent, bool generic);
 
 bool PowWithNumberExponents(const std::unique_ptr<Expr>& expr_a, const std::unique_ptr<Expr>& expr_b);
-bool CanApplyExponentRule(const std::unique_ptr<Expr>& expr, std::string value);
+bool CanApplyExponentRule(const std::unique_ptr<Expr>& expr, symbol::Id value);
 bool SameVariables(const std::unique_ptr<Expr>& expr_a, const std::unique_ptr<Expr>& expr_b);
 
 }
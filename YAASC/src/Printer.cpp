@@ -0,0 +1,191 @@
+#include <sstream>
+#include <charconv>
+
+#include "Printer.h"
+
+namespace printer {
+
+void Printer::Write(char c)
+{
+	m_out.put(c);
+	m_column++;
+}
+
+void Printer::Write(std::string_view text)
+{
+	m_out.write(text.data(), static_cast<std::streamsize>(text.length()));
+	m_column += text.length();
+}
+
+// Integers that fit in 64 bits are formatted without a temporary string
+void Printer::WriteNumber(const std::unique_ptr<Expr>& expr)
+{
+	if (expr->IsInteger() && static_cast<const Integer*>(expr.get())->Atom().IsSmall())
+	{
+		char digits[24];
+		std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), static_cast<const Integer*>(expr.get())->Atom().Small());
+		Write(std::string_view(digits, result.ptr - digits));
+	}
+	else
+		Write(expr->Name());
+}
+
+void Printer::Separator(const std::unique_ptr<Expr>& next_term)
+{
+	if (m_line_width != 0 && m_column >= m_line_width)
+	{
+		m_out.put('\n');
+		m_column = 0;
+	}
+
+	if (!StartsWithMinus(next_term))
+		Write('+');
+}
+
+void Printer::Child(const std::unique_ptr<Expr>& parent, const std::unique_ptr<Expr>& child)
+{
+	bool parenthesis = NeedsParenthesis(parent, child);
+
+	if (parenthesis)
+		Write('(');
+
+	Print(child);
+
+	if (parenthesis)
+		Write(')');
+}
+
+void Printer::Print(const std::unique_ptr<Expr>& expr)
+{
+	if (!expr)
+		return;
+
+	if (expr->IsNumber())
+		WriteNumber(expr);
+	else if (expr->IsVar())
+		Write(symbol::Name(expr->Symbol()));
+	else if (expr->IsFunc())
+	{
+		if (!expr->IsFac())
+			Write(FunctionName(expr->ExpressionType()));
+
+		Write('(');
+		Print(expr->Param());
+		Write(')');
+
+		if (expr->IsFac())
+			Write('!');
+	}
+	else if (expr->IsGeneric())
+	{
+		for (int i = 0; i < expr->ChildrenSize(); i++)
+		{
+			const std::unique_ptr<Expr>& child = expr->ChildAt(i);
+
+			if (i > 0 && expr->IsAdd())
+				Separator(child);
+
+			if (expr->IsMul() && child->IsNegOne())
+				Write('-');
+			else
+				Child(expr, child);
+		}
+	}
+	else if (expr->HasChildren())
+	{
+		if (expr->IsMul() && expr->Left()->IsNegOne())
+			Write('-');
+		else
+			Child(expr, expr->Left());
+
+		if (expr->IsAdd())
+			Separator(expr->Right());
+		else if (expr->IsPow())
+			Write('^');
+
+		Child(expr, expr->Right());
+	}
+	else if (!expr->IsMul())
+		Write(expr->Name());
+}
+
+void Print(const std::unique_ptr<Expr>& expr, std::ostream& out, std::size_t line_width)
+{
+	Printer printer(out, line_width);
+	printer.Print(expr);
+}
+
+std::string ToString(const std::unique_ptr<Expr>& expr, std::size_t line_width)
+{
+	std::ostringstream out;
+	Print(expr, out, line_width);
+
+	return out.str();
+}
+
+// Follows the leftmost path that Printer::Print() would write first
+bool StartsWithMinus(const std::unique_ptr<Expr>& expr)
+{
+	const std::unique_ptr<Expr>* node = &expr;
+
+	while (*node)
+	{
+		const std::unique_ptr<Expr>& current = *node;
+
+		if (current->IsInteger())
+			return static_cast<const Integer*>(current.get())->Atom().Sign() < 0;
+		else if (current->IsNumber())
+			return current->Name()[0] == '-';
+		else if (current->IsVar() || current->IsFunc())
+			return false;
+
+		const std::unique_ptr<Expr>* first = nullptr;
+
+		if (current->IsGeneric())
+			first = &current->ChildAt(0);
+		else if (current->HasChildren())
+			first = &current->Left();
+		else
+			return false;
+
+		if (current->IsMul() && (*first)->IsNegOne())
+			return true;
+
+		if (NeedsParenthesis(current, *first))
+			return false;
+
+		node = first;
+	}
+
+	return false;
+}
+
+bool NeedsParenthesis(const std::unique_ptr<Expr>& parent, const std::unique_ptr<Expr>& child)
+{
+	if (parent->IsPow())
+		return child->IsAdd() || child->IsMul() || child->IsFunc();
+	else if (parent->IsMul())
+		return child->IsAdd();
+
+	return false;
+}
+
+std::string_view FunctionName(ExprType type)
+{
+	switch (type)
+	{
+	case ExprType::LOG:        return "log";
+	case ExprType::LN:         return "ln";
+	case ExprType::SIN:        return "sin";
+	case ExprType::COS:        return "cos";
+	case ExprType::TAN:        return "tan";
+	case ExprType::DERIVATIVE: return "D";
+	case ExprType::INTEGRAL:   return "I";
+	default:
+		break;
+	}
+
+	return "";
+}
+
+} // namespace printer
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <ostream>
+#include <string_view>
+
+#include "Expr.h"
+
+namespace printer {
+
+/* Writes an expression in one pass over the tree, straight to a stream. The sign of a
+*  term is looked up before its separator is written, so that x+(-1)y comes out as x-y
+*  without fixing the text afterwards:
+*
+*      +                       *
+*     / \     --> x-y         / \     --> -(x+1)
+*    x   *                  -1   +
+*       / \                     / \
+*     -1   y                   x   1
+*
+*  With a line width, a line is broken before the next term of a sum once it is at least
+*  that long, so huge results can be streamed in readable pieces.
+*/
+class Printer
+{
+private:
+	std::ostream& m_out;
+	std::size_t m_line_width; // No line breaks when zero
+	std::size_t m_column{ 0 };
+
+	void Write(char c);
+	void Write(std::string_view text);
+	void WriteNumber(const std::unique_ptr<Expr>& expr);
+	void Separator(const std::unique_ptr<Expr>& next_term);
+	void Child(const std::unique_ptr<Expr>& parent, const std::unique_ptr<Expr>& child);
+
+public:
+	Printer(std::ostream& out, std::size_t line_width = 0) : m_out(out), m_line_width(line_width) {}
+
+	void Print(const std::unique_ptr<Expr>& expr);
+};
+
+void Print(const std::unique_ptr<Expr>& expr, std::ostream& out, std::size_t line_width = 0);
+std::string ToString(const std::unique_ptr<Expr>& expr, std::size_t line_width = 0);
+
+bool StartsWithMinus(const std::unique_ptr<Expr>& expr);
+bool NeedsParenthesis(const std::unique_ptr<Expr>& parent, const std::unique_ptr<Expr>& child);
+std::string_view FunctionName(ExprType type);
+
+} // namespace printer
@@ -0,0 +1,69 @@
+#include "Rational.h"
+
+Rational::Rational(BigInt numerator, BigInt denominator)
+	: m_numerator(std::move(numerator)), m_denominator(std::move(denominator))
+{
+	Normalize();
+}
+
+void Rational::Normalize()
+{
+	if (m_denominator.IsZero()) // Left as it is, like the input 1/0
+		return;
+
+	if (m_denominator.Sign() < 0)
+	{
+		m_numerator = -m_numerator;
+		m_denominator = -m_denominator;
+	}
+
+	if (m_denominator == 1)
+		return;
+
+	BigInt gcd = Gcd(m_numerator, m_denominator);
+
+	if (gcd != 1)
+	{
+		m_numerator /= gcd;
+		m_denominator /= gcd;
+	}
+}
+
+Rational Rational::operator-() const
+{
+	Rational negation = *this;
+	negation.m_numerator = -m_numerator;
+
+	return negation;
+}
+
+Rational operator+(const Rational& a, const Rational& b)
+{
+	if (a.IsInteger() && b.IsInteger())
+		return Rational(a.m_numerator + b.m_numerator);
+
+	return Rational(a.m_numerator * b.m_denominator + b.m_numerator * a.m_denominator, a.m_denominator * b.m_denominator);
+}
+
+Rational operator-(const Rational& a, const Rational& b)
+{
+	return a + (-b);
+}
+
+Rational operator*(const Rational& a, const Rational& b)
+{
+	if (a.IsInteger() && b.IsInteger())
+		return Rational(a.m_numerator * b.m_numerator);
+
+	return Rational(a.m_numerator * b.m_numerator, a.m_denominator * b.m_denominator);
+}
+
+Rational operator/(const Rational& a, const Rational& b)
+{
+	return Rational(a.m_numerator * b.m_denominator, a.m_denominator * b.m_numerator);
+}
+
+bool operator==(const Rational& a, const Rational& b)
+{
+	return a.m_numerator == b.m_numerator && a.m_denominator == b.m_denominator;
+}
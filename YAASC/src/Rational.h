@@ -0,0 +1,37 @@
+#pragma once
+
+#include "BigInt.h"
+
+// Exact fraction, always kept in lowest terms with a positive denominator
+class Rational
+{
+private:
+	BigInt m_numerator{ 0 };
+	BigInt m_denominator{ 1 };
+
+	void Normalize();
+
+public:
+	Rational() {}
+	Rational(BigInt integer) : m_numerator(std::move(integer)) {}
+	Rational(BigInt numerator, BigInt denominator);
+
+	const BigInt& Numerator() const { return m_numerator; }
+	const BigInt& Denominator() const { return m_denominator; }
+
+	bool IsInteger() const { return m_denominator == 1; }
+	int Sign() const { return m_numerator.Sign(); }
+
+	double ToDouble() const { return m_numerator.ToDouble() / m_denominator.ToDouble(); }
+	std::string ToString() const { return m_numerator.ToString() + "/" + m_denominator.ToString(); }
+
+	Rational operator-() const;
+
+	friend Rational operator+(const Rational& a, const Rational& b);
+	friend Rational operator-(const Rational& a, const Rational& b);
+	friend Rational operator*(const Rational& a, const Rational& b);
+	friend Rational operator/(const Rational& a, const Rational& b);
+
+	friend bool operator==(const Rational& a, const Rational& b);
+	friend bool operator!=(const Rational& a, const Rational& b) { return !(a == b); }
+};
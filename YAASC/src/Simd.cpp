@@ -0,0 +1,474 @@
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+#if defined __AVX2__
+	#include <immintrin.h>
+#elif defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define YAASC_SSE2
+#endif
+
+#include "Simd.h"
+
+namespace simd {
+
+/* The few vector operations the kernels are written in. Masks are vectors with all bits of
+*  a lane set where a comparison holds, as the instructions produce them.
+*/
+#if defined __AVX2__
+
+constexpr std::size_t width = 4;
+using Vec = __m256d;
+
+static inline Vec Load(const double* p) { return _mm256_loadu_pd(p); }
+static inline void Store(double* p, Vec v) { _mm256_storeu_pd(p, v); }
+static inline Vec Set(double x) { return _mm256_set1_pd(x); }
+static inline Vec Bits(std::uint64_t b) { return _mm256_castsi256_pd(_mm256_set1_epi64x((long long)b)); }
+static inline Vec Add(Vec a, Vec b) { return _mm256_add_pd(a, b); }
+static inline Vec Sub(Vec a, Vec b) { return _mm256_sub_pd(a, b); }
+static inline Vec Mul(Vec a, Vec b) { return _mm256_mul_pd(a, b); }
+static inline Vec Div(Vec a, Vec b) { return _mm256_div_pd(a, b); }
+static inline Vec And(Vec a, Vec b) { return _mm256_and_pd(a, b); }
+static inline Vec Or(Vec a, Vec b) { return _mm256_or_pd(a, b); }
+static inline Vec Not(Vec a) { return _mm256_xor_pd(a, Bits(~0ull)); }
+static inline Vec Less(Vec a, Vec b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+static inline Vec Select(Vec mask, Vec a, Vec b) { return _mm256_blendv_pd(b, a, mask); }
+static inline bool Any(Vec mask) { return _mm256_movemask_pd(mask) != 0; }
+static inline Vec AddBits(Vec a, std::uint64_t b) { return _mm256_castsi256_pd(_mm256_add_epi64(_mm256_castpd_si256(a), _mm256_set1_epi64x((long long)b))); }
+template<int n> static inline Vec ShiftLeft(Vec a) { return _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_castpd_si256(a), n)); }
+template<int n> static inline Vec ShiftRight(Vec a) { return _mm256_castsi256_pd(_mm256_srli_epi64(_mm256_castpd_si256(a), n)); }
+
+#elif defined YAASC_SSE2
+
+constexpr std::size_t width = 2;
+using Vec = __m128d;
+
+static inline Vec Load(const double* p) { return _mm_loadu_pd(p); }
+static inline void Store(double* p, Vec v) { _mm_storeu_pd(p, v); }
+static inline Vec Set(double x) { return _mm_set1_pd(x); }
+static inline Vec Bits(std::uint64_t b) { return _mm_castsi128_pd(_mm_set1_epi64x((long long)b)); }
+static inline Vec Add(Vec a, Vec b) { return _mm_add_pd(a, b); }
+static inline Vec Sub(Vec a, Vec b) { return _mm_sub_pd(a, b); }
+static inline Vec Mul(Vec a, Vec b) { return _mm_mul_pd(a, b); }
+static inline Vec Div(Vec a, Vec b) { return _mm_div_pd(a, b); }
+static inline Vec And(Vec a, Vec b) { return _mm_and_pd(a, b); }
+static inline Vec Or(Vec a, Vec b) { return _mm_or_pd(a, b); }
+static inline Vec Not(Vec a) { return _mm_xor_pd(a, Bits(~0ull)); }
+static inline Vec Less(Vec a, Vec b) { return _mm_cmplt_pd(a, b); }
+static inline Vec Select(Vec mask, Vec a, Vec b) { return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b)); }
+static inline bool Any(Vec mask) { return _mm_movemask_pd(mask) != 0; }
+static inline Vec AddBits(Vec a, std::uint64_t b) { return _mm_castsi128_pd(_mm_add_epi64(_mm_castpd_si128(a), _mm_set1_epi64x((long long)b))); }
+template<int n> static inline Vec ShiftLeft(Vec a) { return _mm_castsi128_pd(_mm_slli_epi64(_mm_castpd_si128(a), n)); }
+template<int n> static inline Vec ShiftRight(Vec a) { return _mm_castsi128_pd(_mm_srli_epi64(_mm_castpd_si128(a), n)); }
+
+#else
+
+constexpr std::size_t width = 1;
+using Vec = double;
+
+static inline std::uint64_t ToBits(double x) { std::uint64_t b; std::memcpy(&b, &x, sizeof(b)); return b; }
+static inline double FromBits(std::uint64_t b) { double x; std::memcpy(&x, &b, sizeof(x)); return x; }
+
+static inline Vec Load(const double* p) { return *p; }
+static inline void Store(double* p, Vec v) { *p = v; }
+static inline Vec Set(double x) { return x; }
+static inline Vec Bits(std::uint64_t b) { return FromBits(b); }
+static inline Vec Add(Vec a, Vec b) { return a + b; }
+static inline Vec Sub(Vec a, Vec b) { return a - b; }
+static inline Vec Mul(Vec a, Vec b) { return a * b; }
+static inline Vec Div(Vec a, Vec b) { return a / b; }
+static inline Vec And(Vec a, Vec b) { return FromBits(ToBits(a) & ToBits(b)); }
+static inline Vec Or(Vec a, Vec b) { return FromBits(ToBits(a) | ToBits(b)); }
+static inline Vec Not(Vec a) { return FromBits(~ToBits(a)); }
+static inline Vec Less(Vec a, Vec b) { return FromBits(a < b ? ~0ull : 0ull); }
+static inline Vec Select(Vec mask, Vec a, Vec b) { return ToBits(mask) != 0 ? a : b; }
+static inline bool Any(Vec mask) { return ToBits(mask) != 0; }
+static inline Vec AddBits(Vec a, std::uint64_t b) { return FromBits(ToBits(a) + b); }
+template<int n> static inline Vec ShiftLeft(Vec a) { return FromBits(ToBits(a) << n); }
+template<int n> static inline Vec ShiftRight(Vec a) { return FromBits(ToBits(a) >> n); }
+
+#endif
+
+constexpr double round_magic = 6755399441055744.0; // 1.5 * 2^52, adding it rounds to an integer in the low bits
+constexpr std::uint64_t two52_bits = 0x4330000000000000ull;
+constexpr std::uint64_t abs_mask = 0x7fffffffffffffffull;
+constexpr std::uint64_t mantissa_mask = 0x000fffffffffffffull;
+constexpr std::uint64_t one_bits = 0x3ff0000000000000ull;
+constexpr std::uint64_t largest_subnormal_bits = 0x000fffffffffffffull;
+constexpr std::uint64_t infinity_bits = 0x7ff0000000000000ull;
+
+constexpr double ln2_hi = 6.93147180369123816490e-01;
+constexpr double ln2_lo = 1.90821492927058770002e-10;
+constexpr double log2e = 1.44269504088896338700e+00;
+constexpr double two_over_pi = 6.36619772367581382433e-01;
+constexpr double pio2_1 = 1.57079632673412561417e+00; // pi/2 in three parts, the first two short enough
+constexpr double pio2_2 = 6.07710050630396597660e-11; // that k * part is exact for the k we reduce with
+constexpr double pio2_3 = 2.02226624871116645580e-21;
+constexpr double trig_limit = 1e5;
+
+static inline Vec Round(Vec x) { return Sub(Add(x, Set(round_magic)), Set(round_magic)); }
+static inline Vec Abs(Vec x) { return And(x, Bits(abs_mask)); }
+
+// The given bit of the integer n in each lane, as 0.0 or its value, with n + round_magic given
+static inline Vec IntegerBit(Vec rounded, std::uint64_t bit)
+{
+	return Sub(Or(And(rounded, Bits(bit)), Bits(two52_bits)), Set(4503599627370496.0));
+}
+
+// Lanes where special is set, like those out of range or NaN, are recomputed with the scalar function
+template<typename F>
+static inline Vec FixUp(Vec special, Vec x, Vec result, F scalar)
+{
+	if (!Any(special))
+		return result;
+
+	double xs[width], rs[width], ss[width];
+	Store(xs, x);
+	Store(rs, result);
+	Store(ss, special);
+
+	for (std::size_t l = 0; l < width; l++)
+	{
+		if (ss[l] != 0.0) // A set mask reads as NaN
+			rs[l] = scalar(xs[l]);
+	}
+
+	return Load(rs);
+}
+
+/* e^x = 2^n e^r with n the nearest integer to x / ln 2, so |r| <= ln 2 / 2 and a Taylor
+*  polynomial of degree 13 is exact to the last bit
+*/
+static inline Vec ExpVec(Vec x)
+{
+	Vec in_range = And(Less(Set(-708.0), x), Less(x, Set(709.0)));
+	Vec clamped = Select(in_range, x, Set(0.0));
+
+	Vec n = Round(Mul(clamped, Set(log2e)));
+	Vec r = Sub(Sub(clamped, Mul(n, Set(ln2_hi))), Mul(n, Set(ln2_lo)));
+
+	static const double coefficients[] = {
+		1.0 / 6227020800.0, 1.0 / 479001600.0, 1.0 / 39916800.0, 1.0 / 3628800.0, 1.0 / 362880.0,
+		1.0 / 40320.0, 1.0 / 5040.0, 1.0 / 720.0, 1.0 / 120.0, 1.0 / 24.0, 1.0 / 6.0, 0.5, 1.0, 1.0
+	};
+
+	Vec p = Set(coefficients[0]);
+
+	for (std::size_t k = 1; k < sizeof(coefficients) / sizeof(double); k++)
+		p = Add(Mul(p, r), Set(coefficients[k]));
+
+	Vec scale = ShiftLeft<52>(AddBits(Add(n, Set(round_magic)), 1023));
+
+	return FixUp(Not(in_range), x, Mul(p, scale), [](double v) { return std::exp(v); });
+}
+
+/* ln x = e ln 2 + ln m with x = m 2^e and m in [sqrt(2)/2, sqrt(2)), and with s = (m-1)/(m+1)
+*  ln m = 2 (s + s^3/3 + s^5/5 + ...), where |s| < 0.172 so a dozen terms are enough
+*/
+static inline Vec LogVec(Vec x)
+{
+	Vec in_range = And(Less(Bits(largest_subnormal_bits), x), Less(x, Bits(infinity_bits)));
+
+	Vec m = Or(And(x, Bits(mantissa_mask)), Bits(one_bits));
+	Vec e = Sub(Or(ShiftRight<52>(And(x, Bits(abs_mask))), Bits(two52_bits)), Set(4503599627370496.0 + 1023.0));
+
+	Vec big = Less(Set(1.41421356237309504880), m);
+	m = Select(big, Mul(m, Set(0.5)), m);
+	e = Select(big, Add(e, Set(1.0)), e);
+
+	Vec f = Sub(m, Set(1.0));
+	Vec s = Div(f, Add(f, Set(2.0)));
+	Vec z = Mul(s, s);
+
+	Vec p = Set(1.0 / 23.0);
+
+	for (int k = 21; k >= 1; k -= 2)
+		p = Add(Mul(p, z), Set(1.0 / k));
+
+	Vec log_m = Mul(Mul(Set(2.0), s), p);
+	Vec result = Add(Mul(e, Set(ln2_hi)), Add(log_m, Mul(e, Set(ln2_lo))));
+
+	return FixUp(Not(in_range), x, result, [](double v) { return std::log(v); });
+}
+
+/* Reduces x to r in [-pi/4, pi/4] with x = k pi/2 + r, and evaluates the sine and cosine
+*  polynomials of r. Which one gives the result, and its sign, depends on k mod 4.
+*/
+enum class Trig { SIN, COS, TAN };
+
+template<Trig function>
+static inline Vec TrigVec(Vec x)
+{
+	Vec in_range = Less(Abs(x), Set(trig_limit));
+	Vec clamped = Select(in_range, x, Set(0.0));
+
+	Vec k = Round(Mul(clamped, Set(two_over_pi)));
+	Vec r = Sub(Sub(Sub(clamped, Mul(k, Set(pio2_1))), Mul(k, Set(pio2_2))), Mul(k, Set(pio2_3)));
+	Vec z = Mul(r, r);
+
+	// sin r = r (1 - z/3! + z^2/5! - ...), cos r = 1 - z/2! + z^2/4! - ...
+	Vec s = Set(-1.0 / 1307674368000.0);
+	s = Add(Mul(s, z), Set(1.0 / 6227020800.0));
+	s = Add(Mul(s, z), Set(-1.0 / 39916800.0));
+	s = Add(Mul(s, z), Set(1.0 / 362880.0));
+	s = Add(Mul(s, z), Set(-1.0 / 5040.0));
+	s = Add(Mul(s, z), Set(1.0 / 120.0));
+	s = Add(Mul(s, z), Set(-1.0 / 6.0));
+	s = Add(Mul(Mul(s, z), r), r);
+
+	Vec c = Set(1.0 / 20922789888000.0);
+	c = Add(Mul(c, z), Set(-1.0 / 87178291200.0));
+	c = Add(Mul(c, z), Set(1.0 / 479001600.0));
+	c = Add(Mul(c, z), Set(-1.0 / 3628800.0));
+	c = Add(Mul(c, z), Set(1.0 / 40320.0));
+	c = Add(Mul(c, z), Set(-1.0 / 720.0));
+	c = Add(Mul(c, z), Set(1.0 / 24.0));
+	c = Add(Mul(c, z), Set(-0.5));
+	c = Add(Mul(c, z), Set(1.0));
+
+	Vec quadrant = Add(k, Set(round_magic));
+
+	if (function == Trig::COS)
+		quadrant = AddBits(quadrant, 1);
+
+	Vec odd = Less(Set(0.5), IntegerBit(quadrant, 1));
+	Vec result;
+
+	if (function == Trig::TAN)
+		result = Select(odd, Div(Sub(Set(0.0), c), s), Div(s, c));
+	else
+	{
+		Vec negative = Less(Set(0.5), IntegerBit(quadrant, 2));
+		result = Select(odd, c, s);
+		result = Select(negative, Sub(Set(0.0), result), result);
+	}
+
+	return FixUp(Not(in_range), x, result, [](double v)
+		{
+			return function == Trig::SIN ? std::sin(v) : function == Trig::COS ? std::cos(v) : std::tan(v);
+		});
+}
+
+// Whole vectors first, then the tail through a padded vector
+template<typename F>
+static void Map(const double* x, double* out, std::size_t n, F f)
+{
+	std::size_t i = 0;
+
+	for (; i + width <= n; i += width)
+		Store(out + i, f(Load(x + i)));
+
+	if (i < n)
+	{
+		double xs[width], rs[width];
+		std::fill(xs, xs + width, 1.0);
+		std::copy(x + i, x + n, xs);
+		Store(rs, f(Load(xs)));
+		std::copy(rs, rs + (n - i), out + i);
+	}
+}
+
+template<typename F>
+static void Map(const double* x, const double* y, double* out, std::size_t n, F f)
+{
+	std::size_t i = 0;
+
+	for (; i + width <= n; i += width)
+		Store(out + i, f(Load(x + i), Load(y + i)));
+
+	if (i < n)
+	{
+		double xs[width], ys[width], rs[width];
+		std::fill(xs, xs + width, 1.0);
+		std::fill(ys, ys + width, 1.0);
+		std::copy(x + i, x + n, xs);
+		std::copy(y + i, y + n, ys);
+		Store(rs, f(Load(xs), Load(ys)));
+		std::copy(rs, rs + (n - i), out + i);
+	}
+}
+
+std::size_t Width()
+{
+	return width;
+}
+
+void Exp(const double* x, double* out, std::size_t n)
+{
+	Map(x, out, n, [](Vec v) { return ExpVec(v); });
+}
+
+void Log(const double* x, double* out, std::size_t n)
+{
+	Map(x, out, n, [](Vec v) { return LogVec(v); });
+}
+
+void Sin(const double* x, double* out, std::size_t n)
+{
+	Map(x, out, n, [](Vec v) { return TrigVec<Trig::SIN>(v); });
+}
+
+void Cos(const double* x, double* out, std::size_t n)
+{
+	Map(x, out, n, [](Vec v) { return TrigVec<Trig::COS>(v); });
+}
+
+void Tan(const double* x, double* out, std::size_t n)
+{
+	Map(x, out, n, [](Vec v) { return TrigVec<Trig::TAN>(v); });
+}
+
+// x^y = e^(y ln x) for positive x; other bases, like (-2)^3, go to std::pow
+void Pow(const double* x, const double* y, double* out, std::size_t n)
+{
+	Map(x, y, out, n, [](Vec a, Vec b)
+		{
+			Vec positive = Less(Set(0.0), a);
+			Vec special = Not(positive);
+			Vec result = ExpVec(Mul(b, LogVec(Select(positive, a, Set(1.0)))));
+
+			if (!Any(special))
+				return result;
+
+			double as[width], bs[width], rs[width], ss[width];
+			Store(as, a);
+			Store(bs, b);
+			Store(rs, result);
+			Store(ss, special);
+
+			for (std::size_t l = 0; l < width; l++)
+			{
+				if (ss[l] != 0.0)
+					rs[l] = std::pow(as[l], bs[l]);
+			}
+
+			return Load(rs);
+		});
+}
+
+// The same exponent in every lane, so all lanes square and multiply in step
+void PowInt(const double* x, std::int32_t exponent, double* out, std::size_t n)
+{
+	std::uint32_t magnitude = exponent < 0 ? 0u - (std::uint32_t)exponent : (std::uint32_t)exponent;
+
+	Map(x, out, n, [=](Vec base)
+		{
+			Vec result = Set(1.0);
+
+			for (std::uint32_t e = magnitude; e != 0; e >>= 1)
+			{
+				if (e & 1)
+					result = Mul(result, base);
+
+				base = Mul(base, base);
+			}
+
+			return exponent < 0 ? Div(Set(1.0), result) : result;
+		});
+}
+
+void Evaluate(const bytecode::Program& program, const std::vector<const double*>& columns, std::size_t count, double* out)
+{
+	using bytecode::Op;
+
+	if (program.Empty())
+	{
+		std::fill(out, out + count, 0.0);
+		return;
+	}
+
+	const std::vector<double>& constants = program.Constants();
+	std::vector<double> registers(program.Registers() * chunk);
+
+	for (std::size_t first = 0; first < count; first += chunk)
+	{
+		std::size_t n = std::min(chunk, count - first);
+		std::size_t lanes = (n + width - 1) / width * width; // Whole vectors, the padding is thrown away
+
+		for (const bytecode::Instruction& instruction : program.Code())
+		{
+			double* d = registers.data() + instruction.d * chunk;
+			const double* a = registers.data() + instruction.a * chunk;
+			const double* b = registers.data() + instruction.b * chunk;
+
+			switch (instruction.op)
+			{
+			case Op::CONST:
+				std::fill(d, d + lanes, constants[instruction.a]);
+				break;
+			case Op::LOAD:
+				std::copy(columns[instruction.a] + first, columns[instruction.a] + first + n, d);
+				std::fill(d + n, d + lanes, 1.0);
+				break;
+			case Op::ADD:
+				for (std::size_t i = 0; i < lanes; i += width)
+					Store(d + i, Add(Load(a + i), Load(b + i)));
+				break;
+			case Op::MUL:
+				for (std::size_t i = 0; i < lanes; i += width)
+					Store(d + i, Mul(Load(a + i), Load(b + i)));
+				break;
+			case Op::ADDK:
+				for (std::size_t i = 0; i < lanes; i += width)
+					Store(d + i, Add(Load(a + i), Set(constants[instruction.b])));
+				break;
+			case Op::MULK:
+				for (std::size_t i = 0; i < lanes; i += width)
+					Store(d + i, Mul(Load(a + i), Set(constants[instruction.b])));
+				break;
+			case Op::NEG:
+				for (std::size_t i = 0; i < lanes; i += width)
+					Store(d + i, Sub(Set(0.0), Load(a + i)));
+				break;
+			case Op::POW:
+				Pow(a, b, d, lanes);
+				break;
+			case Op::POWI:
+				PowInt(a, (std::int32_t)instruction.b, d, lanes);
+				break;
+			case Op::SIN:
+				Sin(a, d, lanes);
+				break;
+			case Op::COS:
+				Cos(a, d, lanes);
+				break;
+			case Op::TAN:
+				Tan(a, d, lanes);
+				break;
+			case Op::LN:
+				Log(a, d, lanes);
+				break;
+			case Op::LOG:
+				Log(a, d, lanes);
+				Map(d, b, d, lanes, [](Vec log_a, Vec base) { return Div(log_a, LogVec(base)); });
+				break;
+			case Op::FAC: // Factorials of constants are folded by the compiler, these are rare
+				for (std::size_t i = 0; i < lanes; i++)
+					d[i] = std::tgamma(a[i] + 1.0);
+				break;
+			}
+		}
+
+		std::copy(registers.data(), registers.data() + n, out + first);
+	}
+}
+
+std::vector<double> Evaluate(const bytecode::Program& program, const std::vector<std::vector<double>>& columns)
+{
+	std::vector<const double*> pointers;
+	std::size_t count = columns.empty() ? 1 : columns[0].size();
+
+	for (const std::vector<double>& column : columns)
+	{
+		pointers.push_back(column.data());
+		count = std::min(count, column.size());
+	}
+
+	std::vector<double> out(count);
+	Evaluate(program, pointers, count, out.data());
+
+	return out;
+}
+
+} // namespace simd
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "Bytecode.h"
+
+namespace simd {
+
+constexpr std::size_t chunk = 256; // Points evaluated per pass over the program, their registers stay in cache
+
+/* Runs a bytecode program over columns of values, one column per slot of the program:
+*
+*      x: 1 2 3 4 ...      3x^2+y  -->  out: 3*1+5  3*4+6  3*9+7 ...
+*      y: 5 6 7 8 ...
+*
+*  Every register holds a chunk of points, and each instruction is one loop over the chunk
+*  in AVX2 (4 lanes) or SSE2 (2 lanes) vectors, depending on what the build targets. The
+*  functions are computed with polynomial approximations in the vectors; lanes outside of
+*  their range, like sin(1e300) or ln(-1), are handed to the standard library.
+*/
+void Evaluate(const bytecode::Program& program, const std::vector<const double*>& columns, std::size_t count, double* out);
+std::vector<double> Evaluate(const bytecode::Program& program, const std::vector<std::vector<double>>& columns); // One value without columns
+
+std::size_t Width(); // Lanes per vector in this build
+
+// Kernels over arrays, out may be the same array as an input
+void Exp(const double* x, double* out, std::size_t n);
+void Log(const double* x, double* out, std::size_t n);
+void Sin(const double* x, double* out, std::size_t n);
+void Cos(const double* x, double* out, std::size_t n);
+void Tan(const double* x, double* out, std::size_t n);
+void Pow(const double* x, const double* y, double* out, std::size_t n);
+void PowInt(const double* x, std::int32_t exponent, double* out, std::size_t n);
+
+} // namespace simd
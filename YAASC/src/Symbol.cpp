@@ -0,0 +1,141 @@
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+
+#include "Symbol.h"
+
+namespace symbol {
+
+/* Names are stored in chunks that are allocated once and never move, chunk k holding
+*  first_chunk << k names. Ids are only handed out after their name is written, so
+*  Name() reads without a lock; the mutex only guards the name -> id map and growth.
+*/
+class Table
+{
+private:
+	static constexpr Id first_chunk = 64;
+	static constexpr int max_chunks = 25; // Chunks 0..24 together cover every non-negative Id
+
+	std::array<std::atomic<std::string*>, max_chunks> m_chunks{};
+	std::unordered_map<std::string, Id> m_ids;
+	mutable std::shared_mutex m_mutex;
+	Id m_size{ 0 };
+	Id m_ordered_count{ 0 };
+
+	// Chunk of an id and its position in the chunk
+	static void Locate(Id id, int& chunk, Id& offset)
+	{
+		Id n = id / first_chunk + 1;
+		chunk = 0;
+
+		while (n >>= 1)
+			chunk++;
+
+		offset = id - first_chunk * ((Id(1) << chunk) - 1);
+	}
+
+public:
+	Table()
+	{
+		// Single letters (and pi) get ids in the same order as their names,
+		// so the common case is ordered without looking at the strings at all
+		std::vector<std::string> names{ "pi" };
+
+		for (char c = 'A'; c <= 'Z'; c++)
+			names.push_back(std::string(1, c));
+
+		for (char c = 'a'; c <= 'z'; c++)
+			names.push_back(std::string(1, c));
+
+		std::sort(names.begin(), names.end());
+
+		for (const std::string& name : names)
+			Intern(name);
+
+		m_ordered_count = m_size;
+	}
+
+	~Table()
+	{
+		for (std::atomic<std::string*>& chunk : m_chunks)
+			delete[] chunk.load();
+	}
+
+	Table(const Table&) = delete;
+	Table& operator=(const Table&) = delete;
+
+	Id Intern(const std::string& name)
+	{
+		{
+			std::shared_lock<std::shared_mutex> lock(m_mutex);
+			auto found = m_ids.find(name);
+
+			if (found != m_ids.end())
+				return found->second;
+		}
+
+		std::unique_lock<std::shared_mutex> lock(m_mutex);
+		auto found = m_ids.find(name);
+
+		if (found != m_ids.end())
+			return found->second;
+
+		Id id = m_size;
+		int chunk;
+		Id offset;
+		Locate(id, chunk, offset);
+
+		if (offset == 0)
+			m_chunks[chunk].store(new std::string[first_chunk << chunk], std::memory_order_release);
+
+		m_chunks[chunk].load(std::memory_order_relaxed)[offset] = name;
+		m_ids.emplace(name, id);
+		m_size++;
+
+		return id;
+	}
+
+	const std::string& Name(Id id) const
+	{
+		int chunk;
+		Id offset;
+		Locate(id, chunk, offset);
+
+		return m_chunks[chunk].load(std::memory_order_acquire)[offset];
+	}
+
+	bool Ordered(Id id) const { return id < m_ordered_count; }
+};
+
+static Table& GlobalTable()
+{
+	static Table table;
+	return table;
+}
+
+Id Intern(const std::string& name)
+{
+	return GlobalTable().Intern(name);
+}
+
+const std::string& Name(Id id)
+{
+	return GlobalTable().Name(id);
+}
+
+// Same order as comparing the names
+bool Less(Id id_a, Id id_b)
+{
+	Table& table = GlobalTable();
+
+	if (table.Ordered(id_a) && table.Ordered(id_b))
+		return id_a < id_b;
+
+	return table.Name(id_a) < table.Name(id_b);
+}
+
+} // namespace symbol
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+
+// Interned variable names. Each distinct name maps to a small integer id, so variables are
+// compared and ordered as integers and the name is only looked up when printing.
+namespace symbol {
+
+using Id = int;
+
+constexpr Id none = -1;
+
+Id Intern(const std::string& name);
+const std::string& Name(Id id);
+
+bool Less(Id id_a, Id id_b);
+
+} // namespace symbol
@@ -1,55 +1,155 @@
 #include "SymbolicTool.h"
 
-#define SHOW_ITERATION_COUNT
-
 namespace yaasc {
 
-void Simplify(std::unique_ptr<Expr>& root) 
+// Returns the number of iterations it took
+int Simplify(std::unique_ptr<Expr>& root)
 {
-	std::unique_ptr<Expr> copy;
+	unsigned settled = 0; // Nothing is settled before the first iteration
 	int i = 0;
 
 	if (!root) // Expression might be empty
-		return;
+		return 0;
+
+	std::vector<std::size_t> previous_hashes{ root->Hash() };
 
 	while (true)
 	{
-		tree_util::Clone(copy, root);
-		Flatten(root);
-		Canonize(root);
-		calculus::Differentiate(root);
-		algebra::PowerOfSum(root);
-		algebra::Expand(root);
-		algebra::ApplyLogarithmRules(root);
-		algebra::AddVariables(root);
-		SimplifyExponents(root, false);
-		algebra::ApplyExponentRules(root);
-		calc::Calculate(root);
-		ReduceToZero(root);
-		ReduceToOne(root);
-		RemoveAdditiveZeros(root);
-		RemoveMulOne(root);
-		i++;
+		Expr::SettleBefore(settled);
+		unsigned generation = Expr::NextGeneration();
+		memo::Table::Session().Trim();
 
-		// When simplification is done
-		if (copy == root)
-		{
-			#if defined SHOW_ITERATION_COUNT
-				std::cout << "\t total iterations: " << i + 1 << '\n';
-			#endif
+		Rewrite(root);
+		i++;
 
+		// When simplification is done: no node was rewritten, or passes undid each other's work
+		// and the tree is back to one of the last few iterations
+		if (root->Generation() < generation ||
+			std::find(previous_hashes.begin(), previous_hashes.end(), root->Hash()) != previous_hashes.end())
 			break;
-		}
+
+		settled = generation;
+
+		if ((int)previous_hashes.size() == recent_root_hashes)
+			previous_hashes.erase(previous_hashes.begin());
+
+		previous_hashes.push_back(root->Hash());
 	}
 
+	Expr::SettleBefore(0);
+
 	// Finally simplifies variables that are raised to one: a^1 --> a
 	SimplifyExponents(root, true);
+
+	return i + 1;
+}
+
+using Rule = void (*)(std::unique_ptr<Expr>&);
+
+static void DifferentiateNode(std::unique_ptr<Expr>& root)
+{
+	calculus::ApplyDerivativeRules(root);
+}
+
+// Local rules of the passes, in the order in which the passes used to run one after another
+static const Rule rules[] = {
+	CanonizeNode,
+	DifferentiateNode,
+	algebra::PowerOfSumNode,
+	algebra::ExpandNode,
+	algebra::LogarithmProductNode,
+	algebra::LogarithmPowerNode,
+	algebra::SimplifySpecialLogarithmNode,
+	algebra::AddVariablesNode,
+	SimplifyExponentsNode,
+	algebra::ExponentRuleParenthesisNode,
+	algebra::ExponentRulePowNode,
+	algebra::ExponentRuleMulNode,
+	calc::CalculateNode,
+	ReduceToZeroNode,
+	ReduceToOneNode,
+	RemoveAdditiveZerosNode,
+	RemoveMulOneNode
+};
+
+// Terms of sums and products are memoized, since the same term often occurs many times
+static void RewriteChildren(std::unique_ptr<Expr>& root)
+{
+	if (root->IsFunc())
+		Rewrite(root->Param());
+	else if (root->IsGeneric())
+	{
+		const memo::Table* caller_table = &memo::Table::Session();
+
+		parallel::ForEachChild(root, [&](std::unique_ptr<Expr>& child) {
+			if (child->IsTerminal() || child->Settled())
+				return;
+
+			memo::Table& table = memo::Table::Session();
+
+			// A helper thread has no keys in use between terms, so it can bound its table here
+			if (&table != caller_table)
+				table.Trim();
+
+			const dag::Node* key = table.Key(child);
+
+			if (table.Find(key, child))
+				return;
+
+			Rewrite(child);
+			table.Insert(key, child);
+		});
+	}
+	else
+	{
+		if (!root->LeftIsTerminal())
+			Rewrite(root->Left());
+
+		if (!root->RightIsTerminal())
+			Rewrite(root->Right());
+	}
+
+	root->Rehash();
+}
+
+/* Rewrites the tree in one bottom-up traversal: children first, then the rules are
+*  applied to the node until it stops changing. When a rule rewrites the node, the
+*  subtrees it built are rewritten before the rules run on the node again, so a rule
+*  that leaves work below the node, like ln(e^2) --> 2ln(e), is finished in place.
+*/
+void Rewrite(std::unique_ptr<Expr>& root)
+{
+	if (root->IsTerminal() || root->Settled())
+		return;
+
+	Splice(root);
+	RewriteChildren(root);
+
+	for (int round = 0; round < max_rewrite_rounds; round++)
+	{
+		std::size_t hash = root->Hash();
+
+		for (Rule rule : rules)
+		{
+			rule(root);
+			root->Rehash();
+		}
+
+		if (root->Hash() == hash)
+			break;
+
+		if (root->IsTerminal())
+			break;
+
+		Splice(root);
+		RewriteChildren(root);
+	}
 }
 
 // Simplifies variables that are raised to zero or one: a^0+a^1 --> 1+a
 void SimplifyExponents(std::unique_ptr<Expr>& root, bool final_modification)
 {
-	if (root->IsTerminal())
+	if (root->IsTerminal() || root->Settled())
 		return;
 
 	if (root->IsGeneric())
@@ -68,8 +168,8 @@ void SimplifyExponents(std::unique_ptr<Expr>& root, bool final_modification)
 			SimplifyExponents(root->Right(), final_modification);
 	}
 
-	if (RaisedToZero(root))
-		root = std::move(std::make_unique<Integer>(1));
+	root->Rehash();
+	SimplifyExponentsNode(root);
 
 	if (final_modification)
 	{
@@ -83,10 +183,19 @@ void SimplifyExponents(std::unique_ptr<Expr>& root, bool final_modification)
 		{
 			for (int i = 0; i < root->ChildrenSize(); i++)
 				SimplifyExponents(root->ChildAt(i), true);
+
+			root->Rehash();
 		}
 	}
 }
 
+// a^0 --> 1
+void SimplifyExponentsNode(std::unique_ptr<Expr>& root)
+{
+	if (RaisedToZero(root))
+		root = std::move(std::make_unique<Integer>(1));
+}
+
 bool Simplified(const std::unique_ptr<Expr>& expr_a, const std::unique_ptr<Expr>& expr_b)
 {
 	if (expr_a == expr_b)
@@ -95,124 +204,81 @@ bool Simplified(const std::unique_ptr<Expr>& expr_a, const std::unique_ptr<Expr>
 	return false;
 }
 
-void Flatten(std::unique_ptr<Expr>& root)
+// Nested node of the same operator, whose operands belong to the node above it
+static bool SameOperator(const std::unique_ptr<Expr>& root, const std::unique_ptr<Expr>& child)
 {
-	std::unique_ptr<Expr> parent = nullptr; // Root has no parent
-	std::queue<std::unique_ptr<Expr>> children;
-	ToGeneric(root, parent, children);
+	return child && child->IsAssociative() && child->ExpressionType() == root->ExpressionType();
 }
 
-/* Flattens the expression tree by making it more generic:
+/* Keeps sums and products flat. When a node has operands of the same operator nested
+*  below it, they are moved up into one generic node, which is then sorted:
 *
 *      *          *
-*     / \       / | \
-*    *   c --> a  b  c
-*   / \
-*  a   b
+*     / \       / | *    *   c --> a  b  c
+*   / *  a   b
 *
+*  The parser builds flat nodes, so only the nodes that rules have nested need this, and
+*  Rewrite() does it on the way down, before a node's children are visited.
 */
-void ToGeneric(std::unique_ptr<Expr>& root, std::unique_ptr<Expr>& parent, std::queue<std::unique_ptr<Expr>>& children) // FIXME: Still has (some serious) issues
+void Splice(std::unique_ptr<Expr>& root)
 {
-	if (root->IsTerminal())
+	if (!root->IsAssociative())
 		return;
 
-	if (root->IsAssociative() && parent && !parent->IsTerminal())
-	{
-		if (root->Name() != parent->Name()) // Joint between two different operators
-		{
-			std::queue<std::unique_ptr<Expr>> sub_children;
-			std::unique_ptr<Expr> null_parent = nullptr;
-			ToGeneric(root, null_parent, sub_children);
-	
-			return;	// Exit sub tree
-		}
-	}
+	std::queue<std::unique_ptr<Expr>> operands;
+	GatherOperands(root, operands, true);
 
-	if (root->IsFunc())
-		ToGeneric(root->Param(), root, children);
-	else if (root->IsGeneric())
+	if (operands.empty())
+		return;
+
+	if (root->IsMul())
+		root = std::make_unique<Mul>();
+	else
+		root = std::make_unique<Add>();
+
+	tree_util::MoveQueueToGenericNode(root, operands);
+	root->SortChildren();
+}
+
+// Operands are gathered from the deepest nested nodes first, then from the nodes above them
+void GatherOperands(std::unique_ptr<Expr>& root, std::queue<std::unique_ptr<Expr>>& operands, bool top)
+{
+	std::size_t nested = operands.size();
+
+	if (root->IsGeneric())
 	{
-		int queue_size = children.size();
-	
 		for (int i = 0; i < root->ChildrenSize(); i++)
 		{
-			if (root->ChildAt(i)->IsAssociative())
-				ToGeneric(root->ChildAt(i), root, children);
+			if (SameOperator(root, root->ChildAt(i)))
+				GatherOperands(root->ChildAt(i), operands, false);
 		}
-	
-		if (queue_size != static_cast<int>(children.size())) // When children size has been updated
+
+		// The top node is left as it is when it has nothing nested
+		if (!top || operands.size() != nested)
 		{
 			for (int i = 0; i < root->ChildrenSize(); i++)
 			{
-				if (!root->ChildAt(i)->IsAssociative())
-					children.push(std::move(root->ChildAt(i)));
+				if (!SameOperator(root, root->ChildAt(i)))
+					operands.push(std::move(root->ChildAt(i)));
 			}
 		}
 	}
-
-	//if (root->IsGeneric())
-	//{
-	//	std::queue<std::unique_ptr<Expr>> sub_children;
-	//	std::unique_ptr<Expr> null_parent = nullptr;
-	//
-	//	for (int i = 0; i < root->ChildrenSize(); i++)
-	//	{
-	//		if (root->ChildAt(i)->IsAssociative())
-	//		{
-	//			if (root->IsAssociative() && root->Name() != root->ChildAt(i)->Name())
-	//				ToGeneric(root->ChildAt(i), null_parent, sub_children);
-	//			else
-	//				ToGeneric(root->ChildAt(i), parent, children);
-	//		}
-	//	}
-	//}
 	else
 	{
-		if (!root->LeftIsTerminal())
-			ToGeneric(root->Left(), root, children);
-
-		if (!root->RightIsTerminal())
-			ToGeneric(root->Right(), root, children);
-	}
-
-	if (root->IsAssociative())
-	{
-		if (parent && root->Name() == parent->Name())
-		{
-			if (root->IsGeneric())
-			{
-				for (int i = 0; i < root->ChildrenSize(); i++)
-					children.push(std::move(root->ChildAt(i)));
+		if (SameOperator(root, root->Left()))
+			GatherOperands(root->Left(), operands, false);
 
-				root->ClearChildren();
-			}
-			else
-			{
-				if (!SameExpressionTypes(root, root->Left()))
-					children.push(std::move(root->Left()));
+		if (SameOperator(root, root->Right()))
+			GatherOperands(root->Right(), operands, false);
 
-				if (!SameExpressionTypes(root, root->Right()))
-					children.push(std::move(root->Right()));
-			}
-		}
-		else if (!root->IsGeneric())
-		{
-			if (root->Name() != root->Left()->Name() && !children.empty())
-				children.push(std::move(root->Left()));
-			else if (root->Name() != root->Right()->Name() && !children.empty())
-				children.push(std::move(root->Right()));
-		}
+		if (top && operands.size() == nested)
+			return;
 
-		if ((!parent || parent->IsPow()) && !children.empty()) // When update is possible
-		{
-			if (root->IsMul())
-				root = std::make_unique<Mul>();
-			else
-				root = std::make_unique<Add>();
+		if (!SameOperator(root, root->Left()))
+			operands.push(std::move(root->Left()));
 
-			tree_util::MoveQueueToGenericNode(root, children);
-			root->SortChildren();
-		}
+		if (!SameOperator(root, root->Right()))
+			operands.push(std::move(root->Right()));
 	}
 }
 
@@ -222,7 +288,7 @@ void ToGeneric(std::unique_ptr<Expr>& root, std::unique_ptr<Expr>& parent, std::
 */
 void Canonize(std::unique_ptr<Expr>& root)
 {
-	if (root->IsTerminal())
+	if (root->IsTerminal() || root->Settled())
 		return;
 
 	if (!root->LeftIsTerminal())
@@ -231,6 +297,12 @@ void Canonize(std::unique_ptr<Expr>& root)
 	if (!root->RightIsTerminal())
 		Canonize(root->Right());
 
+	root->Rehash();
+	CanonizeNode(root);
+}
+
+void CanonizeNode(std::unique_ptr<Expr>& root)
+{
 	if (!root->IsGeneric())
 		CanonizeBinNode(root);
 	else
@@ -291,7 +363,8 @@ void CanonizeGenNode(std::unique_ptr<Expr>& root)
 				CanonizeGenNode(root->ChildAt(i));
 		}
 	}
-		
+
+	root->Rehash();
 }
 
 void ReduceGenNodeToBinNode(std::unique_ptr<Expr>& root)
@@ -338,7 +411,7 @@ bool RaisedToOne(const std::unique_ptr<Expr>& expr)
 
 void RemoveMulOne(std::unique_ptr<Expr>& root)
 {
-	if (root->IsTerminal())
+	if (root->IsTerminal() || root->Settled())
 		return;
 
 	if (root->IsGeneric())
@@ -355,6 +428,12 @@ void RemoveMulOne(std::unique_ptr<Expr>& root)
 			RemoveMulOne(root->Right());
 	}
 
+	root->Rehash();
+	RemoveMulOneNode(root);
+}
+
+void RemoveMulOneNode(std::unique_ptr<Expr>& root)
+{
 	if (!root->IsMul())
 		return;
 
@@ -388,7 +467,7 @@ void RemoveMulOne(std::unique_ptr<Expr>& root)
 
 void RemoveAdditiveZeros(std::unique_ptr<Expr>& root)
 {
-	if (root->IsTerminal())
+	if (root->IsTerminal() || root->Settled())
 		return;
 
 	if (!root->LeftIsTerminal())
@@ -397,6 +476,12 @@ void RemoveAdditiveZeros(std::unique_ptr<Expr>& root)
 	if (!root->RightIsTerminal())
 		RemoveAdditiveZeros(root->Right());
 
+	root->Rehash();
+	RemoveAdditiveZerosNode(root);
+}
+
+void RemoveAdditiveZerosNode(std::unique_ptr<Expr>& root)
+{
 	if (root->IsAdd())
 	{		
 		if (!root->IsGeneric())
@@ -421,7 +506,7 @@ void RemoveAdditiveZeros(std::unique_ptr<Expr>& root)
 
 void ReduceToZero(std::unique_ptr<Expr>& root)
 {
-	if (root->IsTerminal())
+	if (root->IsTerminal() || root->Settled())
 		return;
 
 	if (root->IsGeneric())
@@ -438,6 +523,12 @@ void ReduceToZero(std::unique_ptr<Expr>& root)
 			ReduceToZero(root->Right());
 	}
 
+	root->Rehash();
+	ReduceToZeroNode(root);
+}
+
+void ReduceToZeroNode(std::unique_ptr<Expr>& root)
+{
 	if (root->IsMul())
 	{
 		if (!root->IsGeneric())
@@ -471,7 +562,7 @@ void ReduceToZero(std::unique_ptr<Expr>& root)
 
 void ReduceToOne(std::unique_ptr<Expr>& root)
 {
-	if (root->IsTerminal())
+	if (root->IsTerminal() || root->Settled())
 		return;
 
 	if (root->IsGeneric())
@@ -488,6 +579,12 @@ void ReduceToOne(std::unique_ptr<Expr>& root)
 			ReduceToOne(root->Right());
 	}
 
+	root->Rehash();
+	ReduceToOneNode(root);
+}
+
+void ReduceToOneNode(std::unique_ptr<Expr>& root)
+{
 	if (root->IsPow())
 	{
 		if (root->Left()->IsOne())
@@ -6,21 +6,33 @@
 #include "Expand.h"
 #include "Logarithm.h"
 #include "Calculus.h"
+#include "Memo.h"
+#include "Parallel.h"
 
 namespace yaasc {
 
-void Simplify(std::unique_ptr<Expr>& expr);
+constexpr int max_rewrite_rounds = 8; // Bounds rules that undo each other on one node
+constexpr int recent_root_hashes = 8; // Simplify() stops when the root cycles back to one of these
+
+int Simplify(std::unique_ptr<Expr>& expr);
+void Rewrite(std::unique_ptr<Expr>& root);
 void SimplifyExponents(std::unique_ptr<Expr>& root, bool final_modification);
+void SimplifyExponentsNode(std::unique_ptr<Expr>& root);
 
 void RemoveMulOne(std::unique_ptr<Expr>& root);
+void RemoveMulOneNode(std::unique_ptr<Expr>& root);
 void RemoveAdditiveZeros(std::unique_ptr<Expr>& root);
+void RemoveAdditiveZerosNode(std::unique_ptr<Expr>& root);
 void ReduceToZero(std::unique_ptr<Expr>& root);
+void ReduceToZeroNode(std::unique_ptr<Expr>& root);
 void ReduceToOne(std::unique_ptr<Expr>& root);
+void ReduceToOneNode(std::unique_ptr<Expr>& root);
 
-void Flatten(std::unique_ptr<Expr>& root);
-void ToGeneric(std::unique_ptr<Expr>& root, std::unique_ptr<Expr>& parent, std::queue<std::unique_ptr<Expr>>& children);
+void Splice(std::unique_ptr<Expr>& root);
+void GatherOperands(std::unique_ptr<Expr>& root, std::queue<std::unique_ptr<Expr>>& operands, bool top);
 
 void Canonize(std::unique_ptr<Expr>& root);
+void CanonizeNode(std::unique_ptr<Expr>& root);
 void CanonizeBinNode(std::unique_ptr<Expr>& root);
 void CanonizeGenNode(std::unique_ptr<Expr>& root);
 
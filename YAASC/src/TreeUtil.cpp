@@ -44,85 +44,140 @@ void CopyToStack(std::stack<std::unique_ptr<Expr>>& expr_stack, const std::uniqu
 	if (expr->HasRightChild())
 		CopyToStack(expr_stack, expr->Right());
 
-	if (expr->IsTerminal())
+	switch (expr->ExpressionType())
 	{
-		if (expr->IsVar())
-			expr_stack.push(std::make_unique<Var>(expr->Name()));
-		else if (expr->IsInteger())
-			expr_stack.push(std::make_unique<Integer>(expr->iValue()));
-		else if (expr->IsFloat())
-			expr_stack.push(std::make_unique<Float>(expr->fValue()));
-		else if (expr->IsFraction())
-			expr_stack.push(std::make_unique<Fraction>(expr->Numerator(), expr->Denominator()));
+	case ExprType::VARIABLE:
+		expr_stack.push(std::make_unique<Var>(expr->Symbol()));
+		break;
+	case ExprType::PI:
+		expr_stack.push(std::make_unique<Pi>());
+		break;
+	case ExprType::e:
+		expr_stack.push(std::make_unique<E>());
+		break;
+	case ExprType::INTEGER:
+		expr_stack.push(std::make_unique<Integer>(expr->bValue()));
+		break;
+	case ExprType::FLOAT:
+		expr_stack.push(std::make_unique<Float>(expr->fValue()));
+		break;
+	case ExprType::FRACTION:
+		expr_stack.push(std::make_unique<Fraction>(expr->rValue()));
+		break;
+	case ExprType::FAC:
+	case ExprType::LOG:
+	case ExprType::LN:
+	case ExprType::SIN:
+	case ExprType::COS:
+	case ExprType::TAN:
+	case ExprType::DERIVATIVE:
+	case ExprType::INTEGRAL:
+		CopyFunctionToStack(expr_stack, expr);
+		break;
+	case ExprType::MUL:
+	case ExprType::ADD:
+	case ExprType::POW:
+		if (expr->IsGeneric())
+			CopyGenericToStack(expr_stack, expr);
+		else
+			CopyBinaryToStack(expr_stack, expr);
+		break;
+	default:
+		break;
 	}
-	else if (expr->IsFunc())
-	{
-		std::stack<std::unique_ptr<Expr>> sub_stack;
-		CopyToStack(sub_stack, expr->Param());
-		std::unique_ptr<Expr> parameter = std::move(sub_stack.top());
-		sub_stack.pop();
+}
 
-		if (expr->IsFac())
-			expr_stack.push(std::make_unique<Fac>(std::move(parameter)));
-		else if (expr->IsLog() && expr->Base()->Name() == "10")
+void CopyFunctionToStack(std::stack<std::unique_ptr<Expr>>& expr_stack, const std::unique_ptr<Expr>& expr)
+{
+	std::stack<std::unique_ptr<Expr>> sub_stack;
+	CopyToStack(sub_stack, expr->Param());
+	std::unique_ptr<Expr> parameter = std::move(sub_stack.top());
+	sub_stack.pop();
+
+	switch (expr->ExpressionType())
+	{
+	case ExprType::FAC:
+		expr_stack.push(std::make_unique<Fac>(std::move(parameter)));
+		break;
+	case ExprType::LOG:
+		if (expr->Base()->Name() == "10")
 			expr_stack.push(std::make_unique<Log>(std::move(parameter), std::make_unique<Integer>(10)));
-		else if (expr->IsLog() && expr->Base()->Name() == "2")
+		else if (expr->Base()->Name() == "2")
 			expr_stack.push(std::make_unique<Log>(std::move(parameter), std::make_unique<Integer>(2)));
-		else if (expr->IsLn())
-			expr_stack.push(std::make_unique<Ln>(std::move(parameter)));
-		else if (expr->IsSin())
-			expr_stack.push(std::make_unique<Sin>(std::move(parameter)));
-		else if (expr->IsCos())
-			expr_stack.push(std::make_unique<Cos>(std::move(parameter)));
-		else if (expr->IsTan())
-			expr_stack.push(std::make_unique<Tan>(std::move(parameter)));
-		else if (expr->IsDerivative())
-			expr_stack.push(std::make_unique<Derivative>(std::move(parameter), "x"));
-		else if (expr->IsIntegral())
-			expr_stack.push(std::make_unique<Integral>(std::move(parameter), "x"));
+		break;
+	case ExprType::LN:
+		expr_stack.push(std::make_unique<Ln>(std::move(parameter)));
+		break;
+	case ExprType::SIN:
+		expr_stack.push(std::make_unique<Sin>(std::move(parameter)));
+		break;
+	case ExprType::COS:
+		expr_stack.push(std::make_unique<Cos>(std::move(parameter)));
+		break;
+	case ExprType::TAN:
+		expr_stack.push(std::make_unique<Tan>(std::move(parameter)));
+		break;
+	case ExprType::DERIVATIVE:
+		expr_stack.push(std::make_unique<Derivative>(std::move(parameter), "x"));
+		break;
+	case ExprType::INTEGRAL:
+		expr_stack.push(std::make_unique<Integral>(std::move(parameter), "x"));
+		break;
+	default:
+		break;
+	}
+}
+
+void CopyBinaryToStack(std::stack<std::unique_ptr<Expr>>& expr_stack, const std::unique_ptr<Expr>& expr)
+{
+	std::unique_ptr<Expr> right = nullptr;
+	std::unique_ptr<Expr> left = nullptr;
+
+	if (!expr_stack.empty())
+	{
+		right = std::move(expr_stack.top());
+		expr_stack.pop();
 	}
-	else if (!expr->IsGeneric())
+
+	if (!expr_stack.empty())
 	{
-		std::unique_ptr<Expr> right = nullptr;
-		std::unique_ptr<Expr> left = nullptr;
+		left = std::move(expr_stack.top());
+		expr_stack.pop();
+	}
 
-		if (!expr_stack.empty())
-		{
-			right = std::move(expr_stack.top());
-			expr_stack.pop();
-		}
+	if (!right || !left)
+		return;
 
-		if (!expr_stack.empty())
-		{
-			left = std::move(expr_stack.top());
-			expr_stack.pop();
-		}
-
-		if (right && left)
-		{
-			if (expr->IsMul())
-				expr_stack.push(std::make_unique<Mul>(std::move(left), std::move(right)));
-			else if (expr->IsAdd())
-				expr_stack.push(std::make_unique<Add>(std::move(left), std::move(right)));
-			else if (expr->IsPow())
-				expr_stack.push(std::make_unique<Pow>(std::move(left), std::move(right)));
-		}
+	switch (expr->ExpressionType())
+	{
+	case ExprType::MUL:
+		expr_stack.push(std::make_unique<Mul>(std::move(left), std::move(right)));
+		break;
+	case ExprType::ADD:
+		expr_stack.push(std::make_unique<Add>(std::move(left), std::move(right)));
+		break;
+	case ExprType::POW:
+		expr_stack.push(std::make_unique<Pow>(std::move(left), std::move(right)));
+		break;
+	default:
+		break;
 	}
+}
+
+void CopyGenericToStack(std::stack<std::unique_ptr<Expr>>& expr_stack, const std::unique_ptr<Expr>& expr)
+{
+	if (expr->IsMul())
+		expr_stack.push(std::make_unique<Mul>());
 	else
-	{
-		if (expr->IsMul())
-			expr_stack.push(std::make_unique<Mul>());
-		else
-			expr_stack.push(std::make_unique<Add>());
+		expr_stack.push(std::make_unique<Add>());
 
-		std::queue<std::unique_ptr<Expr>> expr_queue;
-		std::stack<std::unique_ptr<Expr>> sub_stack; // Used for each children in queue
+	std::queue<std::unique_ptr<Expr>> expr_queue;
+	std::stack<std::unique_ptr<Expr>> sub_stack; // Used for each children in queue
 
-		for (int i = 0; i < expr->ChildrenSize(); i++)
-			CopyToQueue(expr_queue, sub_stack, expr->ChildAt(i));
+	for (int i = 0; i < expr->ChildrenSize(); i++)
+		CopyToQueue(expr_queue, sub_stack, expr->ChildAt(i));
 
-		tree_util::MoveQueueToGenericNode(expr_stack.top(), expr_queue);
-	}
+	tree_util::MoveQueueToGenericNode(expr_stack.top(), expr_queue);
 }
 
 void CopyToQueue(std::queue<std::unique_ptr<Expr>>& expr_queue, std::stack<std::unique_ptr<Expr>>& sub_stack, const std::unique_ptr<Expr>& expr)
@@ -1,11 +1,138 @@
 #include<fstream>
+#include<cstdlib>
+#include<regex>
 
 #include "SymbolicTool.h"
 #include "ExprTree.h"
 #include "Clear.h"
+#include "Batch.h"
 
-int main()
+#define SHOW_ITERATION_COUNT
+//#define SHOW_ARENA_STATS
+//#define SHOW_MEMO_STATS
+
+static void PrintUsage()
+{
+	std::cerr << "usage: yaasc                                   interactive mode\n";
+	std::cerr << "       yaasc --batch [file] [--threads n]      one expression per line, from stdin without a file\n";
+	std::cerr << "       yaasc --save file expression            simplify and store the result in binary form\n";
+	std::cerr << "       yaasc --load file                       print an expression stored with --save\n";
+}
+
+// Results go to stdout in input order, statistics to stderr
+static int RunBatch(int argc, char* argv[])
+{
+	std::string path = "";
+	int threads = parallel::DefaultThreads();
+
+	for (int i = 2; i < argc; i++)
+	{
+		std::string arg = argv[i];
+
+		if (arg == "--threads" && i + 1 < argc)
+			threads = std::atoi(argv[++i]);
+		else if (path == "" && arg.rfind("--", 0) != 0)
+			path = arg;
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	if (threads < 1)
+		threads = 1;
+
+	std::ios::sync_with_stdio(false);
+	batch::Stats stats;
+
+	if (path == "" || path == "-")
+		stats = batch::Run(std::cin, std::cout, threads);
+	else
+	{
+		std::ifstream file(path);
+
+		if (!file.is_open())
+		{
+			std::cerr << "Unable to open " << path << '\n';
+			return 1;
+		}
+
+		stats = batch::Run(file, std::cout, threads);
+	}
+
+	batch::PrintStats(stats, std::cerr);
+
+	return 0;
+}
+
+// Keeps a simplified result between runs without parsing it again
+static int RunSave(const std::string& path, const std::string& input)
 {
+	if (scanner::MissingParenthesis(input))
+	{
+		std::cerr << "error: missing parenthesis\n";
+		return 1;
+	}
+
+	yaasc::ExprTree expr_tree(input);
+
+	if (!expr_tree.Root())
+	{
+		std::cerr << "error: couldn't simplify input\n";
+		return 1;
+	}
+
+	{
+		NodeArena::Scope arena_scope(expr_tree.Arena());
+		yaasc::Simplify(expr_tree.Root());
+	}
+
+	if (!expr_tree.Save(path))
+	{
+		std::cerr << "Unable to write " << path << '\n';
+		return 1;
+	}
+
+	std::cout << expr_tree.TreeString() << '\n';
+
+	return 0;
+}
+
+static int RunLoad(const std::string& path)
+{
+	yaasc::ExprTree expr_tree;
+
+	if (!expr_tree.Load(path))
+	{
+		std::cerr << "Unable to load " << path << '\n';
+		return 1;
+	}
+
+	std::ios::sync_with_stdio(false);
+	expr_tree.Write(std::cout);
+	std::cout << '\n';
+
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc > 1)
+	{
+		std::string mode = argv[1];
+
+		if (mode == "--batch")
+			return RunBatch(argc, argv);
+		else if (mode == "--save" && argc == 4)
+			return RunSave(argv[2], argv[3]);
+		else if (mode == "--load" && argc == 3)
+			return RunLoad(argv[2]);
+
+		PrintUsage();
+		return 1;
+	}
+
 	std::cout << "Welcome to use YAASC\n";
 	std::cout << "Source code at: https://github.com/squarematr1x/YAASC";
 	std::cout << "\nEnter the expression you want to simplify\n\n";
@@ -45,7 +172,27 @@ int main()
 		{
 			yaasc::ExprTree expr_tree(input);
 
-			yaasc::Simplify(expr_tree.Root());
+			{
+				// Nodes created while simplifying are freed together with the tree
+				NodeArena::Scope arena_scope(expr_tree.Arena());
+				int iterations = yaasc::Simplify(expr_tree.Root());
+
+				#if defined SHOW_ITERATION_COUNT
+					std::cout << "\t total iterations: " << iterations << '\n';
+				#endif
+			}
+
+			#if defined SHOW_ARENA_STATS
+				std::cout << "\t node allocations: " << expr_tree.Arena().Allocations()
+				          << " (" << expr_tree.Arena().Bytes() << " bytes)\n";
+			#endif
+
+			#if defined SHOW_MEMO_STATS
+				std::cout << "\t memo hits: " << memo::Table::Session().Hits()
+				          << ", misses: " << memo::Table::Session().Misses()
+				          << " (" << memo::Table::Session().Bytes() << " bytes)\n";
+			#endif
+
 			output = expr_tree.TreeString();
 
 			if (output == "")
@@ -60,7 +207,7 @@ int main()
 			else
 				std::cout << "\t couldn't simplify further: ";
 
-			std::cout << expr_tree.TreeString() << '\n';
+			std::cout << output << '\n';
 		}
 
 		i++;
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+
+#include "../src/Archive.h"
+#include "../src/Parser.h"
+#include "../src/Printer.h"
+
+namespace archive {
+
+static const std::string path = "archive_test.yaex";
+
+TEST(TestArchive, RoundTrip)
+{
+	std::vector<std::string> inputs{
+		"3x^2-y/2+z", "sin(x)^2+cos(x)^2", "log2(8)+ln(e)-2pi", "D(x^3)", "123456789012345678901234567890x-1/3", "4!x"
+	};
+
+	for (const std::string& input : inputs)
+	{
+		std::unique_ptr<Expr> expr = parser::Parse(input);
+		ASSERT_TRUE(Save(expr, path)) << input;
+
+		Archive file;
+		ASSERT_TRUE(file.Open(path)) << input;
+		EXPECT_EQ(file.Size(), flat::Tree(expr).Size());
+
+		std::unique_ptr<Expr> loaded = file.ToExpr();
+		ASSERT_NE(loaded, nullptr) << input;
+		EXPECT_EQ(printer::ToString(loaded), printer::ToString(expr)) << input;
+		EXPECT_EQ(loaded->Hash(), expr->Hash()) << input;
+		EXPECT_TRUE(flat::Equal(file.ToTree(), file.Root(), flat::Tree(expr), file.Root())) << input;
+	}
+
+	std::remove(path.c_str());
+}
+
+TEST(TestArchive, InPlaceAccess)
+{
+	ASSERT_TRUE(Save(parser::Parse("x+y"), path));
+
+	Archive file;
+	ASSERT_TRUE(file.Open(path));
+	EXPECT_EQ(file.Kind(file.Root()), ExprType::ADD);
+	EXPECT_EQ(file.ChildrenSize(file.Root()), 2);
+	EXPECT_EQ(file.SubtreeBegin(file.Root()), 0);
+	EXPECT_EQ(file.SymbolName(0), "x");
+
+	std::remove(path.c_str());
+}
+
+TEST(TestArchive, RejectsDamagedFiles)
+{
+	Archive file;
+	EXPECT_FALSE(file.Open("no_such_file.yaex"));
+
+	ASSERT_TRUE(Save(parser::Parse("2x+3y"), path));
+	std::string bytes;
+	{
+		std::ifstream in(path, std::ios::binary);
+		bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	}
+
+	// Truncated
+	std::ofstream(path, std::ios::binary).write(bytes.data(), bytes.size() - 1);
+	EXPECT_FALSE(file.Open(path));
+
+	// A node claiming more children than there are subtrees before it
+	std::string broken = bytes;
+	const Header* header = reinterpret_cast<const Header*>(broken.data());
+	reinterpret_cast<Node*>(&broken[header->node_offset])[0].child_count = 3;
+	std::ofstream(path, std::ios::binary | std::ios::trunc).write(broken.data(), broken.size());
+	ASSERT_TRUE(file.Open(path));
+	EXPECT_EQ(file.ToExpr(), nullptr);
+	EXPECT_TRUE(file.ToTree().Empty());
+
+	std::remove(path.c_str());
+}
+
+} // namespace archive
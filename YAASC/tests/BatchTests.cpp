@@ -0,0 +1,29 @@
+#include <sstream>
+#include <gtest/gtest.h>
+
+#include "../src/Batch.h"
+
+namespace batch {
+
+TEST(TestBatch, OutputInInputOrder)
+{
+	std::istringstream input("x+x\n(a+b\n\n2*3\r\n");
+	std::ostringstream output;
+
+	Stats stats = batch::Run(input, output, 2);
+
+	EXPECT_EQ(output.str(), "2x\nerror: missing parenthesis\n\n6\n");
+	EXPECT_EQ(stats.expressions, 4);
+	EXPECT_EQ(stats.latencies.size(), 4);
+}
+
+TEST(TestBatch, Percentile)
+{
+	std::vector<double> sorted{ 1.0, 2.0, 3.0, 4.0 };
+
+	EXPECT_EQ(Percentile(sorted, 50.0), 2.0);
+	EXPECT_EQ(Percentile(sorted, 100.0), 4.0);
+	EXPECT_EQ(Percentile({}, 50.0), 0.0);
+}
+
+} // namespace batch
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include "../src/Rational.h"
+
+TEST(TestBigInt, SmallToBig)
+{
+	BigInt max = 9223372036854775807LL;
+	BigInt sum = max + 1;
+
+	EXPECT_TRUE(max.IsSmall());
+	EXPECT_FALSE(sum.IsSmall());
+	EXPECT_EQ(sum.ToString(), "9223372036854775808");
+	EXPECT_TRUE((sum - 1).IsSmall());
+	EXPECT_EQ(sum - 1, max);
+	EXPECT_EQ((-sum).ToString(), "-9223372036854775808");
+	EXPECT_TRUE((-sum).IsSmall());
+}
+
+TEST(TestBigInt, Arithmetic)
+{
+	BigInt a = BigInt::FromString("123456789012345678901234567890");
+	BigInt b = BigInt::FromString("-987654321098765432109876543210");
+
+	EXPECT_EQ((a + b).ToString(), "-864197532086419753208641975320");
+	EXPECT_EQ((a * b).ToString(), "-121932631137021795226185032733622923332237463801111263526900");
+	EXPECT_EQ((b / a).ToString(), "-8");
+	EXPECT_EQ((b % a).ToString(), "-9000000000900000000090");
+	EXPECT_EQ(a * b / b, a);
+	EXPECT_EQ(BigInt(2).Pow(100).ToString(), "1267650600228229401496703205376");
+}
+
+TEST(TestBigInt, Gcd)
+{
+	BigInt a = BigInt(2).Pow(80) * 3 * 7;
+	BigInt b = BigInt(2).Pow(70) * 7 * 11;
+
+	EXPECT_EQ(Gcd(a, b), BigInt(2).Pow(70) * 7);
+	EXPECT_EQ(Gcd(BigInt(-12), BigInt(18)), 6);
+	EXPECT_EQ(Gcd(BigInt(0), BigInt(5)), 5);
+}
+
+TEST(TestRational, Normalize)
+{
+	Rational a(6, -4);
+	Rational b(1, 6);
+
+	EXPECT_EQ(a.ToString(), "-3/2");
+	EXPECT_EQ((a + b).ToString(), "-4/3");
+	EXPECT_TRUE((Rational(1, 3) * Rational(3)).IsInteger());
+	EXPECT_EQ(Rational(1, 2) / Rational(1, 4), Rational(2));
+}
+
+TEST(TestBigInt, FastAlgorithmsAgree)
+{
+	BigInt a = BigInt(3).Pow(4000) + 12345;
+	BigInt b = BigInt(7).Pow(2500) - 1;
+	BigInt product = a * b;
+	BigInt quotient = product / (b - 2);
+	BigInt gcd = Gcd(a * 91, b * 91);
+
+	int karatsuba = BigInt::karatsuba_threshold;
+	int toom3 = BigInt::toom3_threshold;
+	int division = BigInt::division_threshold;
+
+	BigInt::karatsuba_threshold = 4;
+	BigInt::toom3_threshold = 12;
+	BigInt::division_threshold = 8;
+
+	EXPECT_EQ(a * b, product);
+	EXPECT_EQ(product / (b - 2), quotient);
+	EXPECT_EQ(Gcd(a * 91, b * 91), gcd);
+	EXPECT_EQ(product % a, 0);
+
+	BigInt::karatsuba_threshold = karatsuba;
+	BigInt::toom3_threshold = toom3;
+	BigInt::division_threshold = division;
+}
+
+TEST(TestBigInt, HashBigValues)
+{
+	BigInt a = BigInt(3).Pow(200);
+	BigInt b = BigInt::FromString(a.ToString());
+
+	EXPECT_EQ(a.Hash(), b.Hash());
+	EXPECT_NE(a.Hash(), (-a).Hash());
+	EXPECT_NE(a.Hash(), (a + 1).Hash());
+	EXPECT_EQ(BigInt(7).Hash(), std::hash<long long>()(7));
+}
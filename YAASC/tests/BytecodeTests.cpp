@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "../src/Bytecode.h"
+#include "../src/Parser.h"
+
+namespace bytecode {
+
+static double Evaluate(const std::string& input, double x, double y = 0.0)
+{
+	Program program(parser::Parse(input));
+	Machine machine(program);
+	std::vector<double> slots(program.Variables().size());
+
+	if (program.SlotOf(symbol::Intern("x")) != -1)
+		slots[program.SlotOf(symbol::Intern("x"))] = x;
+
+	if (program.SlotOf(symbol::Intern("y")) != -1)
+		slots[program.SlotOf(symbol::Intern("y"))] = y;
+
+	return machine.Run(slots);
+}
+
+TEST(TestBytecode, Arithmetic)
+{
+	EXPECT_DOUBLE_EQ(Evaluate("3x^2-y/2+1", 2.0, 5.0), 10.5);
+	EXPECT_DOUBLE_EQ(Evaluate("(x+1)(x-1)", 3.0), 8.0);
+	EXPECT_DOUBLE_EQ(Evaluate("x^-2", 2.0), 0.25);
+	EXPECT_DOUBLE_EQ(Evaluate("2^x", 0.5), std::sqrt(2.0));
+	EXPECT_DOUBLE_EQ(Evaluate("-xy", 2.0, 3.0), -6.0);
+	EXPECT_DOUBLE_EQ(Evaluate("1/3+2", 0.0), 1.0 / 3.0 + 2.0);
+}
+
+TEST(TestBytecode, FunctionsAndConstants)
+{
+	EXPECT_DOUBLE_EQ(Evaluate("sin(x)^2+cos(x)^2", 0.7), 1.0);
+	EXPECT_NEAR(Evaluate("ln(e)+log2(8)+log10(x)", 1000.0), 7.0, 1e-12);
+	EXPECT_DOUBLE_EQ(Evaluate("4!", 0.0), 24.0);
+	EXPECT_DOUBLE_EQ(Evaluate("2pi", 0.0), 2.0 * 3.14159265358979323846);
+	EXPECT_NEAR(Evaluate("tan(x)", 0.3), std::tan(0.3), 1e-15);
+}
+
+TEST(TestBytecode, Compilation)
+{
+	Program program(parser::Parse("3x^2+sin(y)"));
+
+	EXPECT_EQ(program.Size(), 6u);
+	EXPECT_EQ(program.Registers(), 2u);
+	EXPECT_EQ(program.Variables().size(), 2u);
+	EXPECT_EQ(program.Code().back().op, Op::ADD);
+
+	EXPECT_TRUE(Program(parser::Parse("D(x^2)")).Empty());
+	EXPECT_TRUE(Program(nullptr).Empty());
+}
+
+} // namespace bytecode
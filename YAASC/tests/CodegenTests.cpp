@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdlib>
+
+#include "../src/Codegen.h"
+#include "../src/Bytecode.h"
+#include "../src/Parser.h"
+
+namespace codegen {
+
+TEST(TestCodegen, SharedSubterms)
+{
+	Source source = Generate(parser::Parse("sin(x^2)+x^4cos(x^2)"));
+
+	ASSERT_NE(source.code, "");
+	EXPECT_EQ(source.variables.size(), 1u);
+	EXPECT_NE(source.code.find("const double t0 = x[0] * x[0];"), std::string::npos);
+	EXPECT_NE(source.code.find("const double t2 = t0 * t0;"), std::string::npos);
+	EXPECT_NE(source.code.find("sin(t0)"), std::string::npos);
+	EXPECT_NE(source.code.find("cos(t0)"), std::string::npos);
+	EXPECT_EQ(source.temporaries, 6);
+	EXPECT_EQ(source.code.find("pow("), std::string::npos);
+}
+
+TEST(TestCodegen, Literals)
+{
+	EXPECT_EQ(Literal(3.0), "3.0");
+	EXPECT_EQ(Literal(-0.5), "(-0.5)");
+	EXPECT_EQ(Literal(1e300), "1.0000000000000001e+300");
+	EXPECT_EQ(Generate(parser::Parse("D(x^2)")).code, "");
+}
+
+TEST(TestCodegen, CompiledMatchesMachine)
+{
+	if (std::system("cc --version > /dev/null 2>&1") != 0)
+		GTEST_SKIP() << "no C compiler";
+
+	std::vector<std::string> inputs{
+		"3x^5-2x^3y+xy^-2+7", "sin(x)cos(y)+tan(x/4)", "ln(x^2+1)+log2(y)+log10(x^2)", "x^y+2^x-4!pi", "(x+y)^3(x+y)^-2"
+	};
+
+	for (const std::string& input : inputs)
+	{
+		std::unique_ptr<Expr> expr = parser::Parse(input);
+		Library library;
+		ASSERT_TRUE(library.Compile(expr)) << input;
+
+		bytecode::Program program(expr);
+		bytecode::Machine machine(program);
+
+		for (double x : { 0.5, 1.25, 3.0 })
+		{
+			std::vector<double> compiled_slots, machine_slots;
+
+			for (symbol::Id id : library.Variables())
+				compiled_slots.push_back(symbol::Name(id) == "x" ? x : x + 0.75);
+
+			for (symbol::Id id : program.Variables())
+				machine_slots.push_back(symbol::Name(id) == "x" ? x : x + 0.75);
+
+			double expected = machine.Run(machine_slots);
+			EXPECT_NEAR(library.Run(compiled_slots), expected, 1e-12 * std::max(1.0, std::abs(expected))) << input;
+		}
+	}
+}
+
+} // namespace codegen
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "../src/Dense.h"
+#include "../src/Polynomial.h"
+#include "../src/Parser.h"
+
+namespace poly {
+
+static Dense Random(std::size_t length, int limbs, std::mt19937& generator)
+{
+	Dense coefficients(length);
+
+	for (BigInt& coefficient : coefficients)
+	{
+		BigInt::Limbs magnitude(limbs);
+
+		for (std::uint32_t& limb : magnitude)
+			limb = generator();
+
+		coefficient = BigInt(magnitude, generator() % 2 == 0);
+	}
+
+	coefficients.back() = 1;
+
+	return coefficients;
+}
+
+TEST(TestDense, ProductsAgree)
+{
+	std::mt19937 generator(42);
+
+	for (std::size_t length : { 1, 7, 40, 150, 333 })
+	{
+		for (int limbs : { 1, 2, 4 })
+		{
+			Dense a = Random(length, limbs, generator);
+			Dense b = Random(length / 2 + 1, limbs, generator);
+			Dense expected = MulSchoolbook(a, b);
+			Dense product;
+
+			EXPECT_EQ(MulKaratsuba(a, b), expected);
+			ASSERT_TRUE(MulNtt(a, b, product));
+			EXPECT_EQ(product, expected);
+			EXPECT_EQ(Multiply(b, a), expected);
+		}
+	}
+}
+
+TEST(TestDense, TooWideForTheTransform)
+{
+	std::mt19937 generator(7);
+	Dense a = Random(200, 8, generator);
+	Dense product;
+
+	EXPECT_FALSE(MulNtt(a, a, product));
+	EXPECT_EQ(Multiply(a, a), MulSchoolbook(a, a));
+}
+
+TEST(TestDense, UnivariatePowers)
+{
+	Polynomial power;
+	ASSERT_TRUE(FromExpr(parser::Parse("(x+1)^200"), power));
+
+	Dense coefficients = power.ToDense();
+	BigInt binomial = 1;
+
+	ASSERT_EQ(coefficients.size(), 201u);
+
+	for (int k = 0; k <= 200; k++)
+	{
+		EXPECT_EQ(coefficients[k], binomial);
+		binomial = binomial * (200 - k) / (k + 1);
+	}
+
+	Polynomial product;
+	Polynomial expected;
+	ASSERT_TRUE(FromExpr(parser::Parse("(x-1)^150(x+1)^150"), product));
+	ASSERT_TRUE(FromExpr(parser::Parse("(x^2-1)^150"), expected));
+	EXPECT_EQ(product, expected);
+	EXPECT_EQ(product.Terms(), 151);
+}
+
+} // namespace poly
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+
+#include "../src/ExprDag.h"
+#include "../src/Parser.h"
+
+namespace dag {
+
+TEST(TestExprDag, EqualSubtreesShareNode)
+{
+	Store store;
+	std::unique_ptr<Expr> expr_a = parser::Parse("x^2+sin(x^2)");
+	std::unique_ptr<Expr> expr_b = parser::Parse("x^2+sin(x^2)");
+
+	const Node* node_a = store.Intern(expr_a);
+	int size = store.Size();
+
+	// Interning an equal tree again adds nothing and returns the same node
+	EXPECT_EQ(store.Intern(expr_b), node_a);
+	EXPECT_EQ(store.Size(), size);
+
+	// Both occurrences of x^2 are one node
+	const Node* power = store.Intern(expr_a->Left());
+	EXPECT_EQ(node_a->children[0], power);
+	EXPECT_EQ(node_a->children[1]->children[0], power);
+}
+
+TEST(TestExprDag, DifferentSubtreesDoNotShareNode)
+{
+	Store store;
+	std::unique_ptr<Expr> power = parser::Parse("x^2");
+	std::unique_ptr<Expr> other_exponent = parser::Parse("x^3");
+	std::unique_ptr<Expr> other_base = parser::Parse("y^2");
+	std::unique_ptr<Expr> fraction = parser::Parse("1/2");
+	std::unique_ptr<Expr> other_fraction = parser::Parse("1/3");
+
+	const Node* node = store.Intern(power);
+	EXPECT_NE(store.Intern(other_exponent), node);
+	EXPECT_NE(store.Intern(other_base), node);
+	EXPECT_NE(store.Intern(fraction), store.Intern(other_fraction));
+
+	std::unique_ptr<Expr> deriv_x = std::make_unique<Derivative>(parser::Parse("x*y"), symbol::Intern("x"));
+	std::unique_ptr<Expr> deriv_y = std::make_unique<Derivative>(parser::Parse("x*y"), symbol::Intern("y"));
+	EXPECT_NE(store.Intern(deriv_x), store.Intern(deriv_y));
+}
+
+TEST(TestExprDag, BuildRoundTrip)
+{
+	Store store;
+	std::unique_ptr<Expr> expr = parser::Parse("3x^2+log(2,x)-1/2");
+	std::unique_ptr<Expr> built = store.Build(store.Intern(expr));
+
+	EXPECT_TRUE(built == expr);
+	EXPECT_EQ(store.Intern(built), store.Intern(expr));
+}
+
+} // namespace dag
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include "../src/FlatTree.h"
+
+namespace flat {
+
+// 2x^2+sin(y)
+std::unique_ptr<Expr> TestExpression()
+{
+	std::unique_ptr<Expr> expr = std::make_unique<Add>();
+	expr->AddChild(std::make_unique<Mul>(std::make_unique<Integer>(2), std::make_unique<Pow>(std::make_unique<Var>("x"), std::make_unique<Integer>(2))));
+	expr->AddChild(std::make_unique<Sin>(std::make_unique<Var>("y")));
+
+	return expr;
+}
+
+TEST(TestFlatTree, PostOrderLayout)
+{
+	std::unique_ptr<Expr> expr = TestExpression();
+	Tree tree(expr);
+
+	EXPECT_EQ(tree.Size(), 8);
+	EXPECT_EQ(tree.Kind(tree.Root()), ExprType::ADD);
+	EXPECT_EQ(tree.SubtreeBegin(tree.Root()), 0);
+	EXPECT_EQ(tree.ChildrenSize(tree.Root()), 2);
+	EXPECT_EQ(tree.Kind(LeftmostChild(tree, tree.Root())), ExprType::INTEGER);
+	EXPECT_EQ(tree.Hash(tree.Root()), expr->Hash());
+}
+
+TEST(TestFlatTree, RoundTrip)
+{
+	std::unique_ptr<Expr> expr = TestExpression();
+	Tree tree(expr);
+	std::unique_ptr<Expr> copy = tree.ToExpr();
+
+	EXPECT_TRUE(SameExpressions(expr, copy));
+	EXPECT_EQ(ToString(tree), "2x^2+sin(y)");
+}
+
+TEST(TestFlatTree, EqualAndConstant)
+{
+	std::unique_ptr<Expr> expr = TestExpression();
+	std::unique_ptr<Expr> other = std::make_unique<Sin>(std::make_unique<Var>("y"));
+	Tree tree(expr);
+	Tree other_tree(other);
+	Index sin_node = tree.ChildAt(tree.Root(), 1);
+
+	EXPECT_TRUE(Equal(tree, sin_node, other_tree, other_tree.Root()));
+	EXPECT_FALSE(Equal(tree, tree.Root(), other_tree, other_tree.Root()));
+	EXPECT_TRUE(IsConstant(tree, sin_node, symbol::Intern("x")));
+	EXPECT_FALSE(IsConstant(tree, tree.Root(), symbol::Intern("x")));
+}
+
+TEST(TestFlatTree, DerivativeVariable)
+{
+	std::unique_ptr<Expr> deriv_x = std::make_unique<Derivative>(std::make_unique<Var>("x"), "x");
+	std::unique_ptr<Expr> deriv_y = std::make_unique<Derivative>(std::make_unique<Var>("x"), "y");
+	Tree tree_x(deriv_x);
+	Tree tree_y(deriv_y);
+
+	EXPECT_NE(deriv_x->Hash(), deriv_y->Hash());
+	EXPECT_FALSE(SameExpressions(deriv_x, deriv_y));
+	EXPECT_EQ(tree_x.Hash(tree_x.Root()), deriv_x->Hash());
+	EXPECT_EQ(tree_y.Hash(tree_y.Root()), deriv_y->Hash());
+	EXPECT_FALSE(Equal(tree_x, tree_x.Root(), tree_y, tree_y.Root()));
+}
+
+} // namespace flat
@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+
+#include "../src/Memo.h"
+
+namespace memo {
+
+TEST(TestMemo, FindAfterInsert)
+{
+	Table table;
+	std::unique_ptr<Expr> expr = std::make_unique<Mul>(std::make_unique<Integer>(2), std::make_unique<Integer>(3));
+	std::unique_ptr<Expr> result = std::make_unique<Integer>(6);
+	const dag::Node* key = table.Key(expr);
+
+	EXPECT_FALSE(table.Find(key, expr));
+	table.Insert(key, result);
+
+	// A structurally equal copy finds the same entry
+	std::unique_ptr<Expr> copy = std::make_unique<Mul>(std::make_unique<Integer>(2), std::make_unique<Integer>(3));
+	EXPECT_TRUE(table.Find(table.Key(copy), copy));
+	EXPECT_TRUE(copy->IsInteger());
+	EXPECT_EQ(copy->iValue(), 6);
+	EXPECT_EQ(table.Hits(), 1);
+	EXPECT_EQ(table.Misses(), 1);
+}
+
+TEST(TestMemo, TrimOverCap)
+{
+	Table table(1);
+	std::unique_ptr<Expr> expr = std::make_unique<Sin>(std::make_unique<Var>("x"));
+	const dag::Node* key = table.Key(expr);
+
+	table.Insert(key, expr);
+	EXPECT_EQ(table.Size(), 1);
+
+	table.Trim();
+	EXPECT_EQ(table.Size(), 0);
+	EXPECT_EQ(table.Bytes(), 0);
+}
+
+} // namespace memo
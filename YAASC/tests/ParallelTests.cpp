@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+
+#include "../src/SymbolicTool.h"
+#include "../src/ExprTree.h"
+
+namespace parallel {
+
+TEST(TestThreadPool, EachIndexOnce)
+{
+	ThreadPool pool(4);
+	std::vector<int> visits(1000, 0);
+
+	pool.ForEach(static_cast<int>(visits.size()), [&](int i) { visits[i]++; });
+
+	for (int count : visits)
+		EXPECT_EQ(count, 1);
+}
+
+TEST(TestThreadPool, SameResultForAnyThreadCount)
+{
+	std::string input = "";
+
+	for (int i = 1; i <= 2 * min_parallel_children; i++)
+		input += "+(" + std::to_string(i % 7 + 1) + "x+" + std::to_string(i % 5 + 1) + ")^2";
+
+	SetThreads(1);
+	yaasc::ExprTree sequential(input.substr(1));
+	yaasc::Simplify(sequential.Root());
+
+	SetThreads(4);
+	yaasc::ExprTree threaded(input.substr(1));
+	yaasc::Simplify(threaded.Root());
+
+	EXPECT_TRUE(SameExpressions(sequential.Root(), threaded.Root()));
+	EXPECT_EQ(sequential.TreeString(), threaded.TreeString());
+
+	SetThreads(DefaultThreads());
+}
+
+} // namespace parallel
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include "../src/Parser.h"
+#include "../src/FlatTree.h"
+
+namespace parser {
+
+static std::string Parsed(std::string_view input)
+{
+	std::unique_ptr<Expr> expr = Parse(input);
+
+	return expr ? flat::ToString(flat::Tree(expr)) : "";
+}
+
+TEST(TestLexer, Tokens)
+{
+	Lexer lexer("2.5xsin (pi)^--3");
+	std::vector<TokenType> types;
+	std::vector<std::string_view> texts;
+
+	for (; lexer.Peek().type != TokenType::END; lexer.Next())
+	{
+		types.push_back(lexer.Peek().type);
+		texts.push_back(lexer.Peek().text);
+	}
+
+	std::vector<TokenType> expected_types{
+		TokenType::NUMBER, TokenType::VARIABLE, TokenType::FUNCTION, TokenType::LEFT_PARENTHESIS,
+		TokenType::PI, TokenType::RIGHT_PARENTHESIS, TokenType::OPERATOR, TokenType::OPERATOR, TokenType::NUMBER
+	};
+	std::vector<std::string_view> expected_texts{ "2.5", "x", "sin", "(", "pi", ")", "^", "-", "3" };
+
+	EXPECT_EQ(types, expected_types);
+	EXPECT_EQ(texts, expected_texts);
+}
+
+TEST(TestParser, ImplicitMultiplication)
+{
+	EXPECT_EQ(Parsed("3xy"), "3x^1y^1");
+	EXPECT_EQ(Parsed("2(x+1)(x-1)"), "2(x^1+-1)(x^1+1)");
+	EXPECT_EQ(Parsed("x2sin(y)"), "2sin(y^1)x^1");
+	EXPECT_EQ(Parsed("4!x"), "(4)!x^1");
+}
+
+TEST(TestParser, Precedence)
+{
+	EXPECT_EQ(Parsed("x^3^4"), "x^1^3^4");
+	EXPECT_EQ(Parsed("1/2+3/4x"), "1/2+3/4x^1");
+	EXPECT_EQ(Parsed("x/y"), "x^1y^1^-1");
+	EXPECT_EQ(Parsed("-5!+4!"), "-(5)!+(4)!");
+	EXPECT_EQ(Parsed("2^-x"), "2^(-x^1)");
+	EXPECT_EQ(Parsed("x--y"), "x^1+-y^1");
+}
+
+TEST(TestParser, FunctionsAndConstants)
+{
+	EXPECT_EQ(Parsed("log2(8)+log10(x)+ln(e)"), "ln(e^1)+log(x^1)+log(8)");
+	EXPECT_EQ(Parsed("sin(x)^2"), "(sin(x^1))^2");
+	EXPECT_EQ(Parsed("2pi"), "2pi^1");
+	EXPECT_EQ(Parsed("D(x^3)"), "D(x^1^3)");
+}
+
+TEST(TestParser, FlatSumsAndProducts)
+{
+	std::unique_ptr<Expr> sum = Parse("c+(b+a)-d");
+	std::unique_ptr<Expr> product = Parse("2x(yz)/w");
+	std::unique_ptr<Expr> binary = Parse("x+y");
+
+	ASSERT_TRUE(sum->IsGeneric());
+	EXPECT_EQ(sum->ChildrenSize(), 4);
+	EXPECT_EQ(flat::ToString(flat::Tree(sum)), "-d^1+a^1+b^1+c^1");
+	ASSERT_TRUE(product->IsGeneric());
+	EXPECT_EQ(product->ChildrenSize(), 5);
+	EXPECT_FALSE(binary->IsGeneric());
+	EXPECT_TRUE(binary->IsAdd());
+}
+
+TEST(TestParser, Malformed)
+{
+	EXPECT_EQ(Parse("x+"), nullptr);
+	EXPECT_EQ(Parse("sin()"), nullptr);
+	EXPECT_EQ(Parse("(x+1"), nullptr);
+	EXPECT_EQ(Parse(""), nullptr);
+}
+
+} // namespace parser
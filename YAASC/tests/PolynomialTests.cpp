@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include "../src/Polynomial.h"
+#include "../src/Parser.h"
+#include "../src/Printer.h"
+#include "../src/Parallel.h"
+
+namespace poly {
+
+static Polynomial FromString(const std::string& input)
+{
+	Polynomial polynomial;
+	EXPECT_TRUE(FromExpr(parser::Parse(input), polynomial)) << input;
+
+	return polynomial;
+}
+
+TEST(TestPolynomial, Arithmetic)
+{
+	Polynomial x = Polynomial::Variable(symbol::Intern("x"));
+	Polynomial y = Polynomial::Variable(symbol::Intern("y"));
+	Polynomial p = (x + y) * (x + Polynomial(-1) * y);
+
+	EXPECT_EQ(p, FromString("x^2-y^2"));
+	EXPECT_EQ(p.Terms(), 2);
+	EXPECT_TRUE((p + Polynomial(-1) * p).IsZero());
+	EXPECT_EQ(FromString("(x+1)^3"), FromString("x^3+3x^2+3x+1"));
+	EXPECT_EQ(FromString("x(y+1)-xy"), FromString("x"));
+}
+
+TEST(TestPolynomial, HeapProduct)
+{
+	Polynomial p = FromString("(x+y+z+1)^4");
+	Polynomial q = FromString("(x+y+z+1)^3");
+
+	EXPECT_EQ(p * q, FromString("(x+y+z+1)^7"));
+	EXPECT_EQ((p * q).Terms(), 120);
+	EXPECT_EQ(FromString("(x-y)(x^2+xy+y^2)"), FromString("x^3-y^3"));
+	EXPECT_EQ(FromString("(x^5+1)(y^3+x)"), FromString("x^5y^3+x^6+y^3+x"));
+	EXPECT_TRUE((FromString("x+y") * Polynomial()).IsZero());
+}
+
+TEST(TestPolynomial, ParallelProduct)
+{
+	Polynomial p = FromString("(x+y+z+w+1)^6");
+	Polynomial q = FromString("(x-y+2z-w+3)^6");
+
+	parallel::SetThreads(4);
+	Polynomial product = p * q;
+	parallel::SetThreads(parallel::DefaultThreads());
+
+	EXPECT_EQ(product, HeapProduct(p, q));
+	EXPECT_EQ(product, FromString("(x+y+z+w+1)^6(x-y+2z-w+3)^6"));
+}
+
+TEST(TestPolynomial, TermOrder)
+{
+	Polynomial p = FromString("5+y^3+3x^2y-2x");
+
+	ASSERT_EQ(p.Arity(), 2);
+	ASSERT_EQ(p.Terms(), 4);
+	EXPECT_EQ(p.Exponents(0)[0], 2u);
+	EXPECT_EQ(p.Coefficient(0), BigInt(3));
+	EXPECT_EQ(p.Coefficient(1), BigInt(-2));
+	EXPECT_EQ(p.Exponents(2)[1], 3u);
+	EXPECT_EQ(p.Coefficient(3), BigInt(5));
+}
+
+TEST(TestPolynomial, Fractions)
+{
+	Polynomial p = FromString("1/2x+1/3");
+
+	ASSERT_EQ(p.Terms(), 2);
+	EXPECT_EQ(p.Coefficient(0), BigInt(3));
+	EXPECT_EQ(p.Coefficient(1), BigInt(2));
+	EXPECT_EQ(p.Denominator(), BigInt(6));
+
+	EXPECT_EQ(FromString("(x+1/2)(x-1/2)"), FromString("x^2-1/4"));
+	EXPECT_EQ(FromString("1/2x+1/2x"), FromString("x"));
+	EXPECT_EQ(FromString("x+1/2") * Polynomial(2), FromString("2x+1"));
+	EXPECT_EQ((FromString("x+1/2") * Polynomial(2)).Denominator(), BigInt(1));
+	EXPECT_EQ(FromString("(2/3x+1)^2"), FromString("4/9x^2+4/3x+1"));
+}
+
+TEST(TestPolynomial, NotPolynomials)
+{
+	Polynomial p;
+
+	EXPECT_FALSE(FromExpr(parser::Parse("x/2"), p));
+	EXPECT_FALSE(FromExpr(parser::Parse("x^-1"), p));
+	EXPECT_FALSE(FromExpr(parser::Parse("sin(x)+1"), p));
+	EXPECT_FALSE(FromExpr(parser::Parse("pi x"), p));
+	EXPECT_FALSE(FromExpr(parser::Parse("(x+y+z)^100000"), p));
+}
+
+TEST(TestPolynomial, Expand)
+{
+	std::unique_ptr<Expr> expr = parser::Parse("(a+b+c+d)^10");
+
+	ASSERT_TRUE(Expand(expr));
+	EXPECT_EQ(FromString(printer::ToString(expr)).Terms(), 286);
+
+	expr = parser::Parse("(x+y)(x-y)");
+	ASSERT_TRUE(Expand(expr));
+	EXPECT_EQ(printer::ToString(expr), "x^2-y^2");
+
+	expr = parser::Parse("(x+sin(y))^2");
+	EXPECT_FALSE(Expand(expr));
+}
+
+TEST(TestPolynomial, CollectTerms)
+{
+	std::unique_ptr<Expr> expr = parser::Parse("xy+2yx+x");
+
+	ASSERT_TRUE(CollectTerms(expr));
+	EXPECT_EQ(FromString(printer::ToString(expr)), FromString("3xy+x"));
+
+	expr = parser::Parse("xy+x");
+	EXPECT_FALSE(CollectTerms(expr));
+}
+
+} // namespace poly
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include "../src/PowerOfSum.h"
+#include "../src/Bytecode.h"
+#include "../src/Parser.h"
+
+namespace algebra {
+
+static double Evaluate(const std::unique_ptr<Expr>& expr)
+{
+	bytecode::Program program(expr);
+	bytecode::Machine machine(program);
+	std::vector<double> slots(program.Variables().size());
+
+	for (std::size_t slot = 0; slot < slots.size(); slot++)
+		slots[slot] = 0.1 * (slot + 2);
+
+	return machine.Run(slots);
+}
+
+TEST(TestPowerOfSum, Multinomial)
+{
+	std::unique_ptr<Expr> power = parser::Parse("(x+sin(y)+z+ln(w))^6");
+	std::unique_ptr<Expr> expanded = parser::Parse("(x+sin(y)+z+ln(w))^6");
+
+	ApplyMultinomialTheorem(expanded);
+
+	ASSERT_TRUE(expanded->IsAdd());
+	EXPECT_EQ(expanded->ChildrenSize(), 84);
+	EXPECT_NEAR(Evaluate(expanded), Evaluate(power), 1e-12);
+}
+
+TEST(TestPowerOfSum, MultinomialCoefficients)
+{
+	std::unique_ptr<Expr> expanded = parser::Parse("(a+b+c+d+f+g+h+k+m+n)^8");
+
+	ApplyMultinomialTheorem(expanded);
+
+	// The coefficients add up to (1+1+...+1)^8 = 10^8
+	BigInt sum = 0;
+
+	for (int i = 0; i < expanded->ChildrenSize(); i++)
+		sum += expanded->ChildAt(i)->ChildAt(0)->bValue();
+
+	EXPECT_EQ(expanded->ChildrenSize(), 24310);
+	EXPECT_EQ(sum, BigInt(100000000));
+}
+
+// Powers of generic sums go through the multinomial theorem even when they are polynomials
+TEST(TestPowerOfSum, PolynomialSumUsesMultinomial)
+{
+	std::unique_ptr<Expr> expanded = parser::Parse("(x+y+1)^4");
+
+	PowerOfSumNode(expanded);
+
+	ASSERT_TRUE(expanded->IsAdd());
+	ASSERT_EQ(expanded->ChildrenSize(), 15);
+
+	for (int i = 0; i < expanded->ChildrenSize(); i++)
+	{
+		const std::unique_ptr<Expr>& term = expanded->ChildAt(i);
+
+		ASSERT_TRUE(term->IsMul());
+		EXPECT_TRUE(term->ChildAt(0)->IsInteger());
+		EXPECT_TRUE(term->ChildAt(1)->IsPow());
+	}
+}
+
+} // namespace algebra
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "../src/Printer.h"
+#include "../src/Parser.h"
+
+namespace printer {
+
+TEST(TestPrinter, Expressions)
+{
+	std::vector<std::pair<std::string, std::string>> cases{
+		{ "-(x+1)", "-(x^1+1)" },
+		{ "a-2b+c", "-2b^1+a^1+c^1" },
+		{ "2(x+1)(x-1)", "2(x^1-1)(x^1+1)" },
+		{ "x^3^4", "x^1^3^4" },
+		{ "1/2-3/4x", "1/2-3/4x^1" },
+		{ "-5!+4!", "-(5)!+(4)!" },
+		{ "2^-x", "2^(-x^1)" },
+		{ "log2(8)+log10(x)-ln(e)", "-ln(e^1)+log(x^1)+log(8)" },
+		{ "sin(x)^2-cos(y)", "(sin(x^1))^2-cos(y^1)" },
+		{ "x-(y-z)", "x^1-(y^1-z^1)" },
+		{ "-x-y-z", "-x^1-y^1-z^1" },
+		{ "D(x^3)-2pi", "D(x^1^3)-2pi^1" }
+	};
+
+	for (const auto& [input, expected] : cases)
+	{
+		std::unique_ptr<Expr> expr = parser::Parse(input);
+
+		ASSERT_NE(expr, nullptr) << input;
+		EXPECT_EQ(ToString(expr), expected) << input;
+	}
+}
+
+TEST(TestPrinter, Signs)
+{
+	EXPECT_EQ(ToString(parser::Parse("x-y")), "x^1-y^1");
+	EXPECT_EQ(ToString(parser::Parse("x+-3")), "x^1-3");
+	EXPECT_EQ(ToString(std::unique_ptr<Expr>()), "");
+}
+
+TEST(TestPrinter, LineWidth)
+{
+	std::unique_ptr<Expr> expr = parser::Parse("a+b+c+d+e+f");
+	std::ostringstream out;
+
+	Print(expr, out, 6);
+
+	EXPECT_EQ(out.str(), "a^1+b^1\n+c^1+d^1\n+e^1+f^1");
+	EXPECT_EQ(ToString(expr), "a^1+b^1+c^1+d^1+e^1+f^1");
+}
+
+} // namespace printer
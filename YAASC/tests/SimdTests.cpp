@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+#include "../src/Simd.h"
+#include "../src/Parser.h"
+
+namespace simd {
+
+static std::vector<double> Uniform(std::size_t n, double low, double high)
+{
+	std::mt19937 generator(7);
+	std::uniform_real_distribution<double> distribution(low, high);
+	std::vector<double> values(n);
+
+	for (double& value : values)
+		value = distribution(generator);
+
+	return values;
+}
+
+// Largest error relative to the standard library, in units of the result's magnitude
+template<typename Kernel, typename Reference>
+static double MaxError(const std::vector<double>& x, Kernel kernel, Reference reference)
+{
+	std::vector<double> out(x.size());
+	kernel(x.data(), out.data(), x.size());
+	double worst = 0.0;
+
+	for (std::size_t i = 0; i < x.size(); i++)
+	{
+		double expected = reference(x[i]);
+		worst = std::max(worst, std::abs(out[i] - expected) / std::max(1.0, std::abs(expected)));
+	}
+
+	return worst;
+}
+
+TEST(TestSimd, Kernels)
+{
+	std::vector<double> wide = Uniform(1001, -50.0, 50.0);
+	std::vector<double> positive = Uniform(1001, 1e-300, 1e300);
+
+	EXPECT_LT(MaxError(wide, Sin, [](double v) { return std::sin(v); }), 1e-15);
+	EXPECT_LT(MaxError(wide, Cos, [](double v) { return std::cos(v); }), 1e-15);
+	EXPECT_LT(MaxError(Uniform(1001, -1.5, 1.5), Tan, [](double v) { return std::tan(v); }), 1e-14);
+	EXPECT_LT(MaxError(positive, Log, [](double v) { return std::log(v); }), 1e-15);
+	EXPECT_LT(MaxError(Uniform(1001, 1e-3, 10.0), Log, [](double v) { return std::log(v); }), 1e-15);
+
+	std::vector<double> exponents = Uniform(1001, -700.0, 700.0);
+	std::vector<double> out(exponents.size());
+	Exp(exponents.data(), out.data(), out.size());
+
+	for (std::size_t i = 0; i < out.size(); i++)
+		EXPECT_NEAR(out[i] / std::exp(exponents[i]), 1.0, 1e-15);
+}
+
+TEST(TestSimd, SpecialValues)
+{
+	std::vector<double> x{ -1.0, 0.0, INFINITY, NAN, 1e300, -1e-310 };
+	std::vector<double> out(x.size());
+
+	Log(x.data(), out.data(), x.size());
+	EXPECT_TRUE(std::isnan(out[0]));
+	EXPECT_EQ(out[1], -INFINITY);
+	EXPECT_EQ(out[2], INFINITY);
+	EXPECT_TRUE(std::isnan(out[3]));
+
+	Sin(x.data(), out.data(), x.size());
+	EXPECT_DOUBLE_EQ(out[4], std::sin(1e300));
+
+	Exp(x.data(), out.data(), x.size());
+	EXPECT_EQ(out[2], INFINITY);
+	EXPECT_EQ(out[4], INFINITY);
+}
+
+TEST(TestSimd, MatchesMachine)
+{
+	std::vector<std::string> inputs{
+		"3x^5-2x^3y+xy^-2+7", "sin(x)cos(y)+tan(x/4)", "ln(x^2+1)+log2(y^2+1)", "x^y+2^x", "4!x-pi", "e^x"
+	};
+
+	std::vector<double> x = Uniform(1000, -3.0, 3.0);
+	std::vector<double> y = Uniform(1000, 0.5, 2.0);
+
+	for (const std::string& input : inputs)
+	{
+		bytecode::Program program(parser::Parse(input));
+		ASSERT_FALSE(program.Empty()) << input;
+
+		std::vector<std::vector<double>> columns;
+
+		for (symbol::Id id : program.Variables())
+			columns.push_back(symbol::Name(id) == "x" ? x : y);
+
+		std::vector<double> values = Evaluate(program, columns);
+		bytecode::Machine machine(program);
+
+		for (std::size_t i = 0; i < x.size(); i++)
+		{
+			std::vector<double> slots;
+
+			for (const std::vector<double>& column : columns)
+				slots.push_back(column[i]);
+
+			double expected = machine.Run(slots);
+
+			if (std::isnan(expected))
+				EXPECT_TRUE(std::isnan(values[i])) << input;
+			else
+				EXPECT_NEAR(values[i], expected, 1e-12 * std::max(1.0, std::abs(expected))) << input << " at " << i;
+		}
+	}
+}
+
+} // namespace simd
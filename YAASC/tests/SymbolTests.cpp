@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "../src/Symbol.h"
+
+namespace symbol {
+
+TEST(TestSymbol, InternAcrossChunks)
+{
+	std::vector<Id> ids;
+
+	for (int i = 0; i < 1000; i++)
+		ids.push_back(Intern("symbol_test_" + std::to_string(i)));
+
+	for (int i = 0; i < 1000; i++)
+	{
+		EXPECT_EQ(Intern("symbol_test_" + std::to_string(i)), ids[i]);
+		EXPECT_EQ(Name(ids[i]), "symbol_test_" + std::to_string(i));
+	}
+
+	EXPECT_TRUE(Less(Intern("a"), Intern("b")));
+	EXPECT_TRUE(Less(Intern("b"), ids[0]));
+}
+
+TEST(TestSymbol, ConcurrentIntern)
+{
+	std::vector<std::thread> threads;
+	std::vector<std::vector<Id>> ids(4);
+
+	for (int t = 0; t < 4; t++)
+	{
+		threads.emplace_back([t, &ids]() {
+			for (int i = 0; i < 500; i++)
+			{
+				Id id = Intern("concurrent_" + std::to_string(i));
+				ids[t].push_back(id);
+
+				if (Name(id) != "concurrent_" + std::to_string(i))
+					ids[t].push_back(none);
+			}
+		});
+	}
+
+	for (std::thread& thread : threads)
+		thread.join();
+
+	for (int t = 1; t < 4; t++)
+		EXPECT_EQ(ids[t], ids[0]);
+}
+
+} // namespace symbol
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include "../src/SymbolicTool.h"
+#include "../src/ExprTree.h"
+#include "../src/Polynomial.h"
+
+namespace yaasc {
+
+static std::string Simplified(const std::string& input, int& iterations)
+{
+	ExprTree expr_tree(input);
+	NodeArena::Scope arena_scope(expr_tree.Arena());
+
+	iterations = Simplify(expr_tree.Root());
+
+	return expr_tree.TreeString();
+}
+
+// Sums with fractions used to bounce between the polynomial engine and the tree rules
+TEST(TestSimplify, ProductsWithFractions)
+{
+	int iterations = 0;
+
+	EXPECT_EQ(Simplified("(y+2/4)(y+x+9+z)(z-4/4)+(y-z)(4/5-x)(y+x)", iterations),
+		"-xy^2-x^2y-1/2x-1/5y^2-1/5xy-19/2y-3/10xz-9/2+1/2z^2+2xyz+4z+77/10yz+x^2z+yz^2+y^2z");
+	EXPECT_LT(iterations, 10);
+
+	EXPECT_EQ(Simplified("(y+2/4)(y+x+9+z)(z-4/4)+6-y+(y)(x)(8)+z+6+y-z+x+z+1+(y-z)(4/5-x)(y+x)", iterations),
+		"-xy^2-x^2y-1/5y^2-19/2y-3/10xz+1/2x+1/2z^2+17/2+2xyz+39/5xy+5z+77/10yz+x^2z+yz^2+y^2z");
+	EXPECT_LT(iterations, 10);
+}
+
+static poly::Polynomial ToPolynomial(const std::string& input)
+{
+	poly::Polynomial polynomial;
+	EXPECT_TRUE(poly::FromExpr(parser::Parse(input), polynomial)) << input;
+
+	return polynomial;
+}
+
+// Expanded sums with many tied terms used to be reordered on every iteration
+TEST(TestSimplify, PowersOfTrinomials)
+{
+	int iterations = 0;
+
+	for (int n = 5; n <= 7; n++)
+	{
+		std::string input = "(x+y+1)^" + std::to_string(n);
+		std::string output = Simplified(input, iterations);
+
+		EXPECT_LT(iterations, 10) << input;
+		EXPECT_EQ(ToPolynomial(output), ToPolynomial(input)) << input;
+	}
+
+	std::string derivative = Simplified("D((x+y+1)^6)", iterations);
+	EXPECT_LT(iterations, 10);
+	EXPECT_EQ(ToPolynomial(derivative), ToPolynomial("6(x+y+1)^5"));
+}
+
+TEST(TestSimplify, MultinomialExpansion)
+{
+	int iterations = 0;
+
+	for (int n = 5; n <= 8; n++)
+	{
+		std::string input = "(x+y+1)^" + std::to_string(n);
+		poly::Polynomial output = ToPolynomial(Simplified(input, iterations));
+
+		EXPECT_LT(iterations, 10) << input;
+		EXPECT_EQ(output.Terms(), (n + 1) * (n + 2) / 2) << input;
+		EXPECT_EQ(output, ToPolynomial(input)) << input;
+	}
+}
+
+TEST(TestSimplify, LikeTermsWithFractions)
+{
+	int iterations = 0;
+
+	EXPECT_EQ(Simplified("(y+1/2)(x+y)(z-1)+(y-z)(x-1)(y+x)", iterations),
+		"x^2y-x^2z+xy^2-2xy+3/2xz-1/2x+y^2z-2y^2+3/2yz-1/2y");
+}
+
+// Rules that build new subtrees, like the quotient rule and log(a^n) --> nlog(a), are finished in the same rewrite
+TEST(TestSimplify, RewrittenSubtrees)
+{
+	int iterations = 0;
+
+	EXPECT_EQ(Simplified("D(3/x)", iterations), "-3x^-2");
+	EXPECT_EQ(Simplified("D(pi/x)", iterations), "-pix^-2");
+	EXPECT_EQ(Simplified("D(x/y)", iterations), "y^-1");
+	EXPECT_EQ(Simplified("D(x^2/y)", iterations), "2xy^-1");
+	EXPECT_EQ(Simplified("ln(e^2)", iterations), "2");
+	EXPECT_EQ(Simplified("ln(e^3x)", iterations), "3+ln(x)");
+}
+
+// Rational powers with an integer exponent stay exact
+TEST(TestSimplify, ExactPowers)
+{
+	int iterations = 0;
+
+	EXPECT_EQ(Simplified("(1/2)^3", iterations), "1/8");
+	EXPECT_EQ(Simplified("(2/3)^-2", iterations), "9/4");
+	EXPECT_EQ(Simplified("(-1/2)^5", iterations), "-1/32");
+	EXPECT_EQ(Simplified("2^-3", iterations), "1/8");
+}
+
+} // namespace yaasc